@@ -0,0 +1,103 @@
+#pragma once
+#include <algorithm>
+#include <cassert>
+#include <cstddef>
+#include <cstdint>
+#include <vector>
+
+namespace CurveAndDrag {
+
+/**
+ * NoAllocScope - Marks a stretch of audio-thread code that must not allocate
+ *
+ * Allocation paths that know they may run on the audio thread call
+ * assertCanAllocate(), which fails in debug builds inside a scope. Release
+ * builds compile the scope away.
+ */
+struct NoAllocScope {
+#ifndef NDEBUG
+    NoAllocScope() {
+        depth()++;
+    }
+
+    ~NoAllocScope() {
+        depth()--;
+    }
+
+    static void assertCanAllocate() {
+        assert(depth() == 0 && "allocation inside an audio-thread NoAllocScope");
+    }
+
+private:
+    static int& depth() {
+        static thread_local int d = 0;
+        return d;
+    }
+#else
+    static void assertCanAllocate() {}
+#endif
+};
+
+/**
+ * AlignedArena - One preallocated block carved into cache-line aligned arrays
+ *
+ * reserve() allocates the block once; take() hands out zeroed slices of it
+ * and never allocates, so everything carved from the arena can be rebuilt
+ * by rewind() and take() without touching the heap.
+ */
+class AlignedArena {
+public:
+    static constexpr size_t ALIGN_FLOATS = 16; // 64 bytes
+
+    /**
+     * Number of floats reserve() needs for a slice of count floats
+     */
+    static constexpr size_t sliceFloats(size_t count) {
+        return (count + ALIGN_FLOATS - 1) / ALIGN_FLOATS * ALIGN_FLOATS;
+    }
+
+    /**
+     * Make room for at least floats values (allocates only if it grows)
+     */
+    void reserve(size_t floats) {
+        if (floats <= capacity) {
+            return;
+        }
+        NoAllocScope::assertCanAllocate();
+        storage.assign(floats + ALIGN_FLOATS, 0.0f);
+        uintptr_t address = reinterpret_cast<uintptr_t>(storage.data());
+        uintptr_t aligned = (address + ALIGN_FLOATS * sizeof(float) - 1) & ~(uintptr_t(ALIGN_FLOATS * sizeof(float)) - 1);
+        base = reinterpret_cast<float*>(aligned);
+        capacity = floats;
+        used = 0;
+    }
+
+    /**
+     * Release every slice for reuse (keeps the block)
+     */
+    void rewind() {
+        used = 0;
+    }
+
+    /**
+     * Carve a zeroed, 64-byte aligned slice
+     *
+     * @param count Number of floats
+     */
+    float* take(size_t count) {
+        size_t rounded = sliceFloats(count);
+        assert(used + rounded <= capacity && "arena too small");
+        float* slice = base + used;
+        used += rounded;
+        std::fill(slice, slice + count, 0.0f);
+        return slice;
+    }
+
+private:
+    std::vector<float> storage;
+    float* base = nullptr;
+    size_t capacity = 0;
+    size_t used = 0;
+};
+
+} // namespace CurveAndDrag
@@ -0,0 +1,149 @@
+#pragma once
+#include <algorithm>
+#include <atomic>
+#include <condition_variable>
+#include <mutex>
+#include <thread>
+#include <vector>
+#include "WakeSemaphore.hpp"
+
+namespace CurveAndDrag {
+
+/**
+ * AllocationClient - Owner of buffers that are built off the audio thread
+ *
+ * The audio thread calls request() (lock-free) when it needs buffers, or
+ * when it has swapped buffers out; the shared worker then calls allocate()
+ * and collect() on its own thread.
+ */
+struct AllocationClient {
+    std::atomic<bool> requested{false};
+
+    virtual ~AllocationClient() {}
+
+    /**
+     * Build requested buffers (worker thread)
+     */
+    virtual void allocate() = 0;
+
+    /**
+     * Free buffers retired by the audio thread (worker thread, every pass)
+     */
+    virtual void collect() {}
+
+    /**
+     * Ask the worker to run allocate() and collect() soon; safe on the
+     * audio thread
+     */
+    void request();
+};
+
+/**
+ * BackgroundAllocator - Plugin-wide worker that allocates and zeroes buffers
+ *
+ * One thread serves every module instance, so loading a large patch does
+ * not allocate on the engine thread or spawn a thread per module. It
+ * sleeps until a client calls request(), without polling.
+ *
+ * The thread runs only while clients are attached: the first attach()
+ * starts it and the last detach(), from a module destructor, stops and
+ * joins it. The instance itself is never destroyed, so nothing is joined
+ * from a static destructor while the plugin library unloads.
+ */
+class BackgroundAllocator {
+public:
+    static BackgroundAllocator& get() {
+        static BackgroundAllocator* allocator = new BackgroundAllocator;
+        return *allocator;
+    }
+
+    /**
+     * Register a client, starting the thread for the first one (UI thread,
+     * e.g. from a module constructor)
+     */
+    void attach(AllocationClient* client) {
+        std::lock_guard<std::mutex> lifetime(lifetimeMutex);
+        {
+            std::lock_guard<std::mutex> lock(mutex);
+            clients.push_back(client);
+        }
+        if (!worker.joinable()) {
+            running.store(true, std::memory_order_seq_cst);
+            worker = std::thread([this]() { run(); });
+        }
+    }
+
+    /**
+     * Unregister a client; waits for a pass already running on it to
+     * finish, and stops and joins the thread after the last client
+     */
+    void detach(AllocationClient* client) {
+        std::lock_guard<std::mutex> lifetime(lifetimeMutex);
+        bool last;
+        {
+            std::unique_lock<std::mutex> lock(mutex);
+            clients.erase(std::remove(clients.begin(), clients.end(), client), clients.end());
+            served.wait(lock, [this, client]() { return serving != client; });
+            last = clients.empty();
+        }
+        if (last && worker.joinable()) {
+            running.store(false, std::memory_order_seq_cst);
+            wake.post();
+            worker.join();
+        }
+    }
+
+    /**
+     * Wake the worker; safe on the audio thread
+     */
+    void notify() {
+        wake.post();
+    }
+
+private:
+    std::mutex lifetimeMutex;   // Serializes starting and stopping the thread
+    std::mutex mutex;
+    std::condition_variable served;
+    std::vector<AllocationClient*> clients;
+    AllocationClient* serving = nullptr;  // Client being served outside the lock
+    std::thread worker;
+    WakeSemaphore wake;
+    std::atomic<bool> running{false};
+
+    BackgroundAllocator() {}
+
+    void run() {
+        while (true) {
+            wake.wait();
+            if (!running.load(std::memory_order_seq_cst)) {
+                break;
+            }
+            // Clients allocate with the lock released, so attach() and
+            // detach() of other modules never wait on a large allocation;
+            // detach() of the client being served waits for it instead.
+            // The list may change meanwhile, so it is indexed afresh.
+            std::unique_lock<std::mutex> lock(mutex);
+            for (size_t i = 0; i < clients.size(); i++) {
+                AllocationClient* client = clients[i];
+                serving = client;
+                lock.unlock();
+                if (client->requested.exchange(false, std::memory_order_acq_rel)) {
+                    client->allocate();
+                }
+                client->collect();
+                lock.lock();
+                serving = nullptr;
+                served.notify_all();
+            }
+        }
+    }
+};
+
+inline void AllocationClient::request() {
+    // Only the first request since the last pass needs to wake the worker
+    if (!requested.exchange(true, std::memory_order_acq_rel)) {
+        BackgroundAllocator::get().notify();
+    }
+}
+
+} // namespace CurveAndDrag
@@ -0,0 +1,110 @@
+#pragma once
+#include <rack.hpp>
+
+namespace CurveAndDrag {
+
+/**
+ * TCachedBiquad - Biquad filter with change-detecting coefficient cache
+ *
+ * Coefficients are only redesigned when type, frequency, Q, gain or sample
+ * rate actually change. New coefficients are reached by linear interpolation
+ * over a ramp so control-rate updates do not click. T is float, or float_4
+ * to filter four poly voices with shared coefficients.
+ */
+template <typename T = float>
+class TCachedBiquad {
+public:
+    using Type = rack::dsp::BiquadFilter::Type;
+
+    /**
+     * Set filter parameters, redesigning only if something changed
+     *
+     * @param type Biquad response type
+     * @param frequency Cutoff/centre frequency in Hz
+     * @param q Filter Q
+     * @param gain Linear gain (shelf/peak types)
+     * @param sampleRate Current sample rate in Hz
+     * @param rampSamples Samples to glide to the new coefficients (0 = jump)
+     * @return true if coefficients were recomputed
+     */
+    bool setParameters(Type type, float frequency, float q, float gain, float sampleRate, int rampSamples = 0) {
+        if (valid && type == keyType && frequency == keyFrequency && q == keyQ
+            && gain == keyGain && sampleRate == keySampleRate) {
+            return false;
+        }
+        keyType = type;
+        keyFrequency = frequency;
+        keyQ = q;
+        keyGain = gain;
+        keySampleRate = sampleRate;
+
+        // Design once into a scratch filter and keep only its coefficients
+        designer.setParameters(type, frequency / sampleRate, q, gain);
+        for (int i = 0; i < 3; i++) targetB[i] = designer.b[i];
+        for (int i = 0; i < 2; i++) targetA[i] = designer.a[i];
+
+        if (!valid || rampSamples <= 0) {
+            filter.setCoefficients(targetB, targetA);
+            rampRemaining = 0;
+        } else {
+            float invN = 1.0f / rampSamples;
+            for (int i = 0; i < 3; i++) stepB[i] = (targetB[i] - filter.b[i]) * invN;
+            for (int i = 0; i < 2; i++) stepA[i] = (targetA[i] - filter.a[i]) * invN;
+            rampRemaining = rampSamples;
+        }
+        valid = true;
+        return true;
+    }
+
+    /**
+     * Process one sample, advancing any coefficient ramp in progress
+     *
+     * @param input Input sample
+     * @return Filtered sample
+     */
+    T process(T input) {
+        if (rampRemaining > 0) {
+            if (--rampRemaining == 0) {
+                filter.setCoefficients(targetB, targetA);
+            } else {
+                for (int i = 0; i < 3; i++) filter.b[i] += stepB[i];
+                for (int i = 0; i < 2; i++) filter.a[i] += stepA[i];
+            }
+        }
+        return filter.process(input);
+    }
+
+    /**
+     * Clear filter history and finish any coefficient ramp
+     */
+    void reset() {
+        if (valid) {
+            filter.setCoefficients(targetB, targetA);
+        }
+        rampRemaining = 0;
+        filter.reset();
+    }
+
+private:
+    rack::dsp::TBiquadFilter<T> filter;
+    rack::dsp::BiquadFilter designer;
+
+    // Cache key
+    bool valid = false;
+    Type keyType = rack::dsp::BiquadFilter::LOWPASS;
+    float keyFrequency = 0.0f;
+    float keyQ = 0.0f;
+    float keyGain = 0.0f;
+    float keySampleRate = 0.0f;
+
+    // Coefficient interpolation
+    T targetB[3] = {};
+    T targetA[2] = {};
+    T stepB[3] = {};
+    T stepA[2] = {};
+    int rampRemaining = 0;
+};
+
+typedef TCachedBiquad<> CachedBiquad;
+
+} // namespace CurveAndDrag
@@ -46,7 +46,7 @@ CurveAndDragModule::CurveAndDragModule() {
     configParam(DETUNE_R_PARAM, -1.0f, 1.0f, 0.0f, "Right Channel Detune: ±50 cents", " cents", 0.0f, 50.0f);
     configParam(QUANTIZE_PARAM, 0.0f, 1.0f, 0.0f, "Quantize to Scale: Enable pitch correction");
     configParam(MORPH_PARAM, 0.0f, 1.0f, 0.0f, "Morph: Blend between pitch algorithms");
-    configParam(PITCH_MODE_PARAM, 0.0f, 3.0f, 1.0f, "Pitch Algorithm: BBD/H910/Varispeed/Hybrid");
+    configParam(PITCH_MODE_PARAM, 0.0f, 4.0f, 1.0f, "Pitch Algorithm: BBD/H910/Varispeed/Hybrid/Spectral");
     configParam(CHARACTER_PARAM, 0.0f, 1.0f, 0.5f, "Character: Vintage pitch shifter modeling", "%", 0.0f, 100.0f);
     
     // Configure scale and tuning parameters (2)
@@ -112,10 +112,17 @@ CurveAndDragModule::CurveAndDragModule() {
     
     // Initialize audio processing components
     float sampleRate = APP->engine->getSampleRate();
-    leftDelay.configure(sampleRate);
-    rightDelay.configure(sampleRate);
-    pitchShifter.configure(sampleRate);
-    tapeProcessor.configure(sampleRate);
+    for (int g = 0; g < MAX_GROUPS; g++) {
+        leftDelay[g].configure(sampleRate);
+        rightDelay[g].configure(sampleRate);
+        tapeProcessor[g].configure(sampleRate);
+    }
+    
+    // Build the first voice group's delay buffers off the audio thread
+    allocSampleRate = sampleRate;
+    bufferClient.module = this;
+    BackgroundAllocator::get().attach(&bufferClient);
+    bufferClient.request();
     
     // Initialize scala reader with default 12-TET
     scalaReader.setDefaultScale();
@@ -125,13 +132,27 @@ CurveAndDragModule::CurveAndDragModule() {
     rightTapTrigger.reset();
 }
 
+CurveAndDragModule::~CurveAndDragModule() {
+    // Wait out an allocation pass that may be using this module
+    BackgroundAllocator::get().detach(&bufferClient);
+}
+
 // ===== RESET AND CONFIGURATION =====
 void CurveAndDragModule::onReset() {
     // Reset all audio processing components
-    leftDelay.reset();
-    rightDelay.reset();
-    pitchShifter.reset();
-    tapeProcessor.reset();
+    for (int g = 0; g < MAX_GROUPS; g++) {
+        leftDelay[g].reset();
+        rightDelay[g].reset();
+        tapeProcessor[g].reset();
+        pitchEngines[g].reset();
+        characterOversamplerL[g].reset();
+        characterOversamplerR[g].reset();
+        crossFeedback[g].reset();
+    }
+    for (int v = 0; v < spectralVoicesReady.load(); v++) {
+        spectralVoices[v]->reset();
+    }
+    pitchSmoothing.reset();
     
     // Reset timers and triggers
     leftTapTimer.reset();
@@ -150,95 +171,154 @@ void CurveAndDragModule::onReset() {
     // Reset process counter
     processCounter = 0;
     
-    // Reset CV modulation storage
-    pitchCVModulation = 0.0f;
-    outputGainModulation = 0.0f;
-    timeCVGlobal = 0.0f;
-    feedbackCVGlobal = 0.0f;
+    // Clear the block buffers
+    blockPos = 0;
+    for (int g = 0; g < MAX_GROUPS; g++) {
+        blockOutputL[g].fill(0.0f);
+        blockOutputR[g].fill(0.0f);
+        blockWetL[g].fill(0.0f);
+        blockWetR[g].fill(0.0f);
+    }
+    
+    // Re-read all parameters on the next block
+    controlFrames = CONTROL_RATE;
 }
 
 void CurveAndDragModule::onSampleRateChange() {
     float sampleRate = APP->engine->getSampleRate();
     
     // Reconfigure all components for new sample rate
-    leftDelay.configure(sampleRate);
-    rightDelay.configure(sampleRate);
-    pitchShifter.configure(sampleRate);
-    tapeProcessor.configure(sampleRate);
-}
-
-// ===== v2.8.0 CRITICAL FIX: All 21 CV Inputs Functional =====
-void CurveAndDragModule::processAllCVInputs() {
-    // Process core delay CV inputs (6)
-    if (inputs[TIME_L_CV_INPUT].isConnected()) {
-        float cvValue = inputs[TIME_L_CV_INPUT].getVoltage() / 10.0f; // ±10V to ±1 range
-        float currentTime = params[TIME_L_PARAM].getValue();
-        float newTime = clamp(currentTime + cvValue * 0.2f, 0.0f, 1.0f); // ±20% modulation
-        leftDelay.setDelayTime(newTime * 2000.0f);
-    }
-    
-    if (inputs[TIME_R_CV_INPUT].isConnected()) {
-        float cvValue = inputs[TIME_R_CV_INPUT].getVoltage() / 10.0f;
-        float currentTime = params[TIME_R_PARAM].getValue();
-        float newTime = clamp(currentTime + cvValue * 0.2f, 0.0f, 1.0f);
-        rightDelay.setDelayTime(newTime * 2000.0f);
-    }
-    
-    if (inputs[FEEDBACK_L_CV_INPUT].isConnected()) {
-        float cvValue = inputs[FEEDBACK_L_CV_INPUT].getVoltage() / 10.0f;
-        float currentFeedback = params[FEEDBACK_L_PARAM].getValue();
-        leftDelay.setFeedback(clamp(currentFeedback + cvValue * 0.1f, 0.0f, 1.1f));
-    }
-    
-    if (inputs[FEEDBACK_R_CV_INPUT].isConnected()) {
-        float cvValue = inputs[FEEDBACK_R_CV_INPUT].getVoltage() / 10.0f;
-        float currentFeedback = params[FEEDBACK_R_PARAM].getValue();
-        rightDelay.setFeedback(clamp(currentFeedback + cvValue * 0.1f, 0.0f, 1.1f));
+    for (int g = 0; g < MAX_GROUPS; g++) {
+        leftDelay[g].configure(sampleRate);
+        rightDelay[g].configure(sampleRate);
+        tapeProcessor[g].configure(sampleRate);
     }
     
-    if (inputs[MIX_L_CV_INPUT].isConnected()) {
-        float cvValue = inputs[MIX_L_CV_INPUT].getVoltage() / 10.0f;
-        float mixParam = clamp(params[MIX_L_PARAM].getValue() + cvValue, 0.0f, 1.0f);
-        leftDelay.setDryWet(mixParam);
+    // Buffers for the new rate are built off-thread and swapped in with a short fade
+    allocSampleRate = sampleRate;
+    bufferClient.request();
+}
+
+// ===== OFF-THREAD BUFFER ALLOCATION =====
+void CurveAndDragModule::allocateBuffers() {
+    float sampleRate = allocSampleRate.load();
+    int groups = allocGroups.load();
+    bool withTape = allocTape.load();
+    int pitchModes = allocPitchModes.load();
+    
+    // Only voice groups, tape loops and pitch engines that have been used
+    // get memory; buffers already built are left as they are
+    for (int g = 0; g < groups; g++) {
+        leftDelay[g].prepareBuffer(sampleRate);
+        rightDelay[g].prepareBuffer(sampleRate);
+        if (withTape) {
+            tapeProcessor[g].prepareTape(sampleRate);
+        }
+        pitchEngines[g].prepareBuffers(pitchModes);
     }
     
-    if (inputs[MIX_R_CV_INPUT].isConnected()) {
-        float cvValue = inputs[MIX_R_CV_INPUT].getVoltage() / 10.0f;
-        float mixParam = clamp(params[MIX_R_PARAM].getValue() + cvValue, 0.0f, 1.0f);
-        rightDelay.setDryWet(mixParam);
+    // Spectral voices are only ever added, each published once it is built
+    int spectralVoiceCount = allocSpectralVoices.load();
+    for (int v = spectralVoicesReady.load(); v < spectralVoiceCount; v++) {
+        spectralVoices[v].reset(new SpectralVoice(sampleRate));
+        spectralVoicesReady.store(v + 1, std::memory_order_release);
     }
-    
-    // Process global modulation CV inputs (2)
-    if (inputs[TIME_MOD_INPUT].isConnected()) {
-        timeCVGlobal = inputs[TIME_MOD_INPUT].getVoltage() / 10.0f; // ±100ms range
-    } else {
-        timeCVGlobal = 0.0f;
+}
+
+void CurveAndDragModule::collectBuffers() {
+    for (int g = 0; g < MAX_GROUPS; g++) {
+        leftDelay[g].collectBuffer();
+        rightDelay[g].collectBuffer();
+        tapeProcessor[g].collectBuffers();
     }
-    
-    if (inputs[FEEDBACK_MOD_INPUT].isConnected()) {
-        feedbackCVGlobal = inputs[FEEDBACK_MOD_INPUT].getVoltage() / 10.0f; // ±10% range
-    } else {
-        feedbackCVGlobal = 0.0f;
+}
+
+// ===== CONTROL-RATE PARAMETER SNAPSHOT =====
+void CurveAndDragModule::updateParameterSnapshot() {
+    ParameterSnapshot& s = snapshot;
+    
+    // Time, feedback and pitch accept poly CV; a mono cable applies to every voice
+    for (int c = 0; c < channels; c++) {
+        // Global modulation CV inputs (2)
+        float timeMod = inputs[TIME_MOD_INPUT].isConnected() ?
+                        inputs[TIME_MOD_INPUT].getPolyVoltage(c) / 10.0f : 0.0f;     // ±100ms range
+        float feedbackMod = inputs[FEEDBACK_MOD_INPUT].isConnected() ?
+                            inputs[FEEDBACK_MOD_INPUT].getPolyVoltage(c) / 10.0f : 0.0f; // ±10% range
+        
+        // Core delay parameters with CV (6)
+        s.timeL[c] = getClampedParam(TIME_L_PARAM, TIME_L_CV_INPUT, 0.0f, 1.0f, 0.0f, c) * 2000.0f + timeMod * 100.0f;
+        s.timeR[c] = getClampedParam(TIME_R_PARAM, TIME_R_CV_INPUT, 0.0f, 1.0f, 0.0f, c) * 2000.0f + timeMod * 100.0f;
+        
+        // Per-channel feedback CV takes priority over the global feedback modulation
+        float feedbackCVL = inputs[FEEDBACK_L_CV_INPUT].isConnected() ?
+                            inputs[FEEDBACK_L_CV_INPUT].getPolyVoltage(c) / 10.0f : feedbackMod;
+        float feedbackCVR = inputs[FEEDBACK_R_CV_INPUT].isConnected() ?
+                            inputs[FEEDBACK_R_CV_INPUT].getPolyVoltage(c) / 10.0f : feedbackMod;
+        s.feedbackL[c] = clamp(params[FEEDBACK_L_PARAM].getValue() + feedbackCVL * 0.1f, 0.0f, 1.1f);
+        s.feedbackR[c] = clamp(params[FEEDBACK_R_PARAM].getValue() + feedbackCVR * 0.1f, 0.0f, 1.1f);
+        
+        s.basePitch[c] = getClampedParam(PITCH_PARAM, PITCH_CV_INPUT, -2.0f, 2.0f, 0.0f, c) * 600.0f; // ±1200 cents
     }
     
-    // Process pitch shift CV inputs (3)
-    if (inputs[PITCH_CV_INPUT].isConnected()) {
-        pitchCVModulation = inputs[PITCH_CV_INPUT].getVoltage() * 20.0f; // 1V/oct = 20 cents/V
-    } else {
-        pitchCVModulation = 0.0f;
-    }
+    float mixCVL = inputs[MIX_L_CV_INPUT].isConnected() ? inputs[MIX_L_CV_INPUT].getVoltage() / 10.0f : 0.0f;
+    float mixCVR = inputs[MIX_R_CV_INPUT].isConnected() ? inputs[MIX_R_CV_INPUT].getVoltage() / 10.0f : 0.0f;
+    s.delayMixL = clamp(params[MIX_L_PARAM].getValue() + mixCVL, 0.0f, 1.0f);
+    s.delayMixR = clamp(params[MIX_R_PARAM].getValue() + mixCVR, 0.0f, 1.0f);
+    s.outputMixL = clamp(params[MIX_L_PARAM].getValue(), 0.0f, 1.0f);
+    s.outputMixR = clamp(params[MIX_R_PARAM].getValue(), 0.0f, 1.0f);
+    
+    // Sync, routing and gain (7)
+    s.syncL = params[SYNC_L_PARAM].getValue() > 0.5f;
+    s.syncR = params[SYNC_R_PARAM].getValue() > 0.5f;
+    s.subdivL = clamp(static_cast<int>(params[SUBDIV_L_PARAM].getValue()), 0, 5);
+    s.subdivR = clamp(static_cast<int>(params[SUBDIV_R_PARAM].getValue()), 0, 5);
+    s.crossFeedback = params[CROSS_FEEDBACK_PARAM].getValue();
+    s.inputGain = getClampedParam(INPUT_GAIN_PARAM, INPUT_GAIN_CV_INPUT, 0.0f, 2.0f);
+    s.outputGain = getClampedParam(OUTPUT_GAIN_PARAM, OUTPUT_GAIN_CV_INPUT, 0.0f, 2.0f);
+    
+    // Pitch parameters with CV (9 + per-voice base pitch above)
+    s.detuneL = getClampedParam(DETUNE_L_PARAM, DETUNE_L_CV_INPUT, -1.0f, 1.0f) * 50.0f; // ±50 cents
+    s.detuneR = getClampedParam(DETUNE_R_PARAM, DETUNE_R_CV_INPUT, -1.0f, 1.0f) * 50.0f; // ±50 cents
+    s.detuneDrift = getClampedParam(DETUNE_DRIFT_PARAM, DETUNE_DRIFT_CV_INPUT, 0.0f, 1.0f) * 25.0f; // 0-25 cents
+    s.character = getClampedParam(CHARACTER_PARAM, CHARACTER_CV_INPUT, 0.0f, 1.0f);
+    s.morph = getClampedParam(MORPH_PARAM, MORPH_CV_INPUT, 0.0f, 1.0f);
+    s.pitchMode = clamp(static_cast<int>(params[PITCH_MODE_PARAM].getValue()), 0, 4);
+    s.quantize = params[QUANTIZE_PARAM].getValue() > 0.5f;
+    s.mtsEnabled = params[MTS_ENABLE_PARAM].getValue() > 0.5f;
+    s.scaleIndex = clamp(static_cast<int>(params[SCALE_SELECT_PARAM].getValue()), 0, 10);
+    
+    // Tape parameters with CV (17)
+    s.tapeMode = params[TAPE_MODE_PARAM].getValue() > 0.5f;
+    s.wowRate = getClampedParam(WOW_RATE_PARAM, WOW_RATE_CV_INPUT, 0.1f, 5.0f);
+    s.wowDepth = getClampedParam(WOW_DEPTH_PARAM, WOW_DEPTH_CV_INPUT, 0.0f, 1.0f);
+    s.flutterRate = getClampedParam(FLUTTER_RATE_PARAM, FLUTTER_RATE_CV_INPUT, 1.0f, 15.0f);
+    s.flutterDepth = getClampedParam(FLUTTER_DEPTH_PARAM, FLUTTER_DEPTH_CV_INPUT, 0.0f, 1.0f);
+    s.wowWaveform = clamp(static_cast<int>(params[WOW_WAVEFORM_PARAM].getValue()), 0, 2);
+    s.flutterWaveform = clamp(static_cast<int>(params[FLUTTER_WAVEFORM_PARAM].getValue()), 0, 2);
+    s.saturation = getClampedParam(SATURATION_PARAM, SATURATION_CV_INPUT, 0.0f, 1.0f);
+    s.bumpFreq = getClampedParam(HEAD_BUMP_FREQ_PARAM, -1, 60.0f, 250.0f, 90.0f);
+    s.bumpGain = getClampedParam(HEAD_BUMP_GAIN_PARAM, -1, 0.5f, 3.0f, 1.2f);
+    s.rolloffFreq = getClampedParam(ROLLOFF_FREQ_PARAM, -1, 5000.0f, 15000.0f, 10000.0f);
+    s.rolloffResonance = getClampedParam(ROLLOFF_RESONANCE_PARAM, -1, 0.1f, 2.0f, 0.7f);
+    s.aging = getClampedParam(AGING_PARAM, AGING_CV_INPUT, 0.0f, 1.0f);
+    s.instability = getClampedParam(INSTABILITY_PARAM, INSTABILITY_CV_INPUT, 0.0f, 1.0f);
+    s.headConfig = static_cast<int>(getClampedParam(HEAD_SELECT_PARAM, HEAD_SELECT_CV_INPUT, 0.0f, 3.0f));
+    s.noiseEnabled = params[TAPE_NOISE_PARAM].getValue() > 0.5f;
+    s.noiseAmount = getClampedParam(NOISE_AMOUNT_PARAM, NOISE_AMOUNT_CV_INPUT, 0.0f, 1.0f);
+}
+
+void CurveAndDragModule::applyParameterSnapshot(int frames) {
+    // Process delay parameters with CV
+    processDelayParameters();
     
-    // Process detune drift CV (already handled in processPitchParameters)
-    // Process morph CV (already handled in processPitchParameters)
+    // Process pitch parameters with CV
+    processPitchParameters(frames);
     
-    // Process gain CV inputs (3)
-    // Input gain CV handled in main process function
-    // Output gain CV handled in main process function
-    // Character CV handled in pitch processing
+    // Process tape mode with full functionality
+    processTapeMode(frames);
     
-    // Process tape delay CV inputs (10)
-    // Note: These are handled in processTapeMode() via getClampedParam()
-    // All tape parameters support CV modulation through that mechanism
+    // Process tempo sync
+    processTempo();
 }
 
 // ===== v2.8.0 CRITICAL FIX: Subdivision Display =====
@@ -261,9 +341,6 @@ void CurveAndDragModule::updateParameterDisplays() {
     }
     
     // 4. Update tempo sync when subdivision parameters change
-    static float lastLeftSubdiv = -1.0f;
-    static float lastRightSubdiv = -1.0f;
-    
     float currentLeftSubdiv = params[SUBDIV_L_PARAM].getValue();
     float currentRightSubdiv = params[SUBDIV_R_PARAM].getValue();
     
@@ -282,87 +359,89 @@ void CurveAndDragModule::updateParameterDisplays() {
 // ===== v2.8.0 TEMPO SYNC WITH MUSICAL SUBDIVISIONS =====
 void CurveAndDragModule::processTempo() {
     // Left channel tempo sync
-    if (params[SYNC_L_PARAM].getValue() > 0.5f) {
-        int subdivIndex = static_cast<int>(params[SUBDIV_L_PARAM].getValue());
-        SubdivisionType subdivType = static_cast<SubdivisionType>(clamp(subdivIndex, 0, 5));
+    if (snapshot.syncL) {
+        SubdivisionType subdivType = static_cast<SubdivisionType>(snapshot.subdivL);
         float subdivMultiplier = getSubdivisionMultiplier(subdivType);
         
         // Calculate delay time based on BPM and subdivision
         float beatTimeMs = (60.0f / detectedBPM) * 1000.0f; // ms per beat
         float syncedDelayTime = beatTimeMs * subdivMultiplier;
-        leftDelay.setDelayTime(clamp(syncedDelayTime, 1.0f, 2000.0f));
+        for (auto& delay : leftDelay) {
+            delay.setDelayTime(clamp(syncedDelayTime, 1.0f, 2000.0f));
+        }
     }
     
     // Right channel tempo sync
-    if (params[SYNC_R_PARAM].getValue() > 0.5f) {
-        int subdivIndex = static_cast<int>(params[SUBDIV_R_PARAM].getValue());
-        SubdivisionType subdivType = static_cast<SubdivisionType>(clamp(subdivIndex, 0, 5));
+    if (snapshot.syncR) {
+        SubdivisionType subdivType = static_cast<SubdivisionType>(snapshot.subdivR);
         float subdivMultiplier = getSubdivisionMultiplier(subdivType);
         
         float beatTimeMs = (60.0f / detectedBPM) * 1000.0f;
         float syncedDelayTime = beatTimeMs * subdivMultiplier;
-        rightDelay.setDelayTime(clamp(syncedDelayTime, 1.0f, 2000.0f));
+        for (auto& delay : rightDelay) {
+            delay.setDelayTime(clamp(syncedDelayTime, 1.0f, 2000.0f));
+        }
     }
 }
 
 // ===== v2.8.0 CRITICAL FIX: Tape Mode with Full Stereo Output =====
-void CurveAndDragModule::processTapeMode() {
-    if (params[TAPE_MODE_PARAM].getValue() < 0.5f) {
-        tapeProcessor.setTapeMode(false);
-        return;
+void CurveAndDragModule::processTapeMode(int frames) {
+    const ParameterSnapshot& s = snapshot;
+    
+    // Tape loops are only allocated once tape mode is first used
+    if (s.tapeMode && !allocTape.load(std::memory_order_relaxed)) {
+        allocTape = true;
+        bufferClient.request();
     }
     
-    tapeProcessor.setTapeMode(true);
-    
-    // ===== CRITICAL FIX: Complete Tape Parameter Configuration =====
-    
-    // 1. Wow and Flutter with proper waveform configuration
-    float wowRate = getClampedParam(WOW_RATE_PARAM, WOW_RATE_CV_INPUT, 0.1f, 5.0f);
-    float wowDepth = getClampedParam(WOW_DEPTH_PARAM, WOW_DEPTH_CV_INPUT, 0.0f, 1.0f);
-    float flutterRate = getClampedParam(FLUTTER_RATE_PARAM, FLUTTER_RATE_CV_INPUT, 1.0f, 15.0f);
-    float flutterDepth = getClampedParam(FLUTTER_DEPTH_PARAM, FLUTTER_DEPTH_CV_INPUT, 0.0f, 1.0f);
-    
-    // Get waveform types and convert to enum
-    int wowWaveformInt = static_cast<int>(params[WOW_WAVEFORM_PARAM].getValue());
-    int flutterWaveformInt = static_cast<int>(params[FLUTTER_WAVEFORM_PARAM].getValue());
-    WowFlutterWaveform wowWaveform = static_cast<WowFlutterWaveform>(clamp(wowWaveformInt, 0, 2));
-    WowFlutterWaveform flutterWaveform = static_cast<WowFlutterWaveform>(clamp(flutterWaveformInt, 0, 2));
-    
-    // Configure complete wow/flutter system
-    tapeProcessor.setWowFlutter(wowRate, wowDepth, flutterRate, flutterDepth, wowWaveform, flutterWaveform);
-    
-    // 2. Tape saturation with proper scaling
-    float saturation = getClampedParam(SATURATION_PARAM, SATURATION_CV_INPUT, 0.0f, 1.0f);
-    tapeProcessor.setSaturation(saturation);
-    
-    // 3. Head Bump EQ with proper frequency and gain control
-    float bumpFreq = getClampedParam(HEAD_BUMP_FREQ_PARAM, -1, 60.0f, 250.0f, 90.0f);
-    float bumpGain = getClampedParam(HEAD_BUMP_GAIN_PARAM, -1, 0.5f, 3.0f, 1.2f);
-    float bumpQ = 1.2f; // Fixed Q factor for vintage character
-    tapeProcessor.setHeadBump(bumpFreq, bumpGain, bumpQ);
-    
-    // 4. High-frequency rolloff filter
-    float rolloffFreq = getClampedParam(ROLLOFF_FREQ_PARAM, -1, 5000.0f, 15000.0f, 10000.0f);
-    float rolloffRes = getClampedParam(ROLLOFF_RESONANCE_PARAM, -1, 0.1f, 2.0f, 0.7f);
-    tapeProcessor.setRolloff(rolloffFreq, rolloffRes);
-    
-    // 5. Tape aging and instability for vintage character
-    float agingAmount = getClampedParam(AGING_PARAM, AGING_CV_INPUT, 0.0f, 1.0f);
-    float instability = getClampedParam(INSTABILITY_PARAM, INSTABILITY_CV_INPUT, 0.0f, 1.0f);
-    tapeProcessor.setAging(agingAmount);
-    tapeProcessor.setInstability(instability);
-    
-    // 6. Multi-head configuration for delay taps
-    int headConfig = static_cast<int>(getClampedParam(HEAD_SELECT_PARAM, HEAD_SELECT_CV_INPUT, 0.0f, 3.0f));
-    tapeProcessor.setHeadConfiguration(headConfig);
-    
-    // 7. Tape noise with proper scaling
-    bool noiseEnabled = params[TAPE_NOISE_PARAM].getValue() > 0.5f;
-    float noiseAmount = getClampedParam(NOISE_AMOUNT_PARAM, NOISE_AMOUNT_CV_INPUT, 0.0f, 1.0f);
-    tapeProcessor.setNoiseParameters(noiseEnabled, noiseAmount);
+    // Every voice group in use shares the same tape settings; setTapeMode()
+    // only acts when the switch changes, so calling it every period is cheap.
+    // Groups beyond the channel count are not processed, so their fades
+    // would never finish: they stop at once instead.
+    int groups = (channels + 3) / 4;
+    for (int g = groups; g < MAX_GROUPS; g++) {
+        tapeProcessor[g].stopTape();
+    }
+    for (int g = 0; g < groups; g++) {
+        TTapeDelayProcessor<float_4>& tape = tapeProcessor[g];
+        if (!s.tapeMode) {
+            tape.setTapeMode(false);
+            continue;
+        }
+        
+        tape.setTapeMode(true);
+        
+        // ===== CRITICAL FIX: Complete Tape Parameter Configuration =====
+        
+        // 1. Wow and Flutter with proper waveform configuration
+        WowFlutterWaveform wowWaveform = static_cast<WowFlutterWaveform>(s.wowWaveform);
+        WowFlutterWaveform flutterWaveform = static_cast<WowFlutterWaveform>(s.flutterWaveform);
+        tape.setWowFlutter(s.wowRate, s.wowDepth, s.flutterRate, s.flutterDepth, wowWaveform, flutterWaveform);
+        
+        // 2. Tape saturation with proper scaling
+        tape.setSaturation(s.saturation);
+        
+        // 3. Head Bump EQ with proper frequency and gain control
+        // (coefficients are cached; knob changes glide over the control period)
+        float bumpQ = 1.2f; // Fixed Q factor for vintage character
+        tape.setHeadBump(s.bumpFreq, s.bumpGain, bumpQ, frames);
+        
+        // 4. High-frequency rolloff filter
+        tape.setRolloff(s.rolloffFreq, s.rolloffResonance, frames);
+        
+        // 5. Tape aging and instability for vintage character
+        tape.setAging(s.aging);
+        tape.setInstability(s.instability);
+        
+        // 6. Multi-head configuration for delay taps
+        tape.setHeadConfiguration(s.headConfig);
+        
+        // 7. Tape noise with proper scaling
+        tape.setNoiseParameters(s.noiseEnabled, s.noiseAmount);
+    }
 }
 
-// ===== v2.8.0 MAIN PROCESS FUNCTION - COMPLETE SIGNAL FLOW =====
+// ===== v2.8.0 MAIN PROCESS FUNCTION - BLOCK DRIVER =====
 void CurveAndDragModule::process(const ProcessArgs& args) {
     // Increment process counter for rate limiting
     processCounter++;
@@ -377,408 +456,404 @@ void CurveAndDragModule::process(const ProcessArgs& args) {
         mtsClient.pollForMtsConnection();
     }
     
-    // Process all CV inputs for complete automation (21 inputs)
-    processAllCVInputs();
+    // Process tap tempo (trigger edges need every frame)
+    processTapTempo(args.sampleRate);
     
-    // Process delay parameters with CV
-    processDelayParameters(args.sampleRate);
+    // Apply a pending block size, interpolation, oversampling, channel count and vocoder setting change on a block boundary
+    if (blockPos == 0) {
+        blockSize = clamp(requestedBlockSize.load(), MIN_BLOCK_SIZE, MAX_BLOCK_SIZE);
+        if (interpolation != requestedInterpolation) {
+            interpolation = requestedInterpolation;
+            for (int g = 0; g < MAX_GROUPS; g++) {
+                leftDelay[g].setInterpolation(interpolation);
+                rightDelay[g].setInterpolation(interpolation);
+            }
+        }
+        if (oversampling != requestedOversampling) {
+            oversampling = requestedOversampling;
+            for (int g = 0; g < MAX_GROUPS; g++) {
+                characterOversamplerL[g].setFactor(oversampling);
+                characterOversamplerR[g].setFactor(oversampling);
+                tapeProcessor[g].setOversampling(oversampling);
+            }
+        }
+        channels = std::max({1, inputs[LEFT_INPUT].getChannels(), inputs[RIGHT_INPUT].getChannels()});
+        
+        // New voice groups get their buffers from the allocator thread
+        int neededGroups = (channels + 3) / 4;
+        if (neededGroups > allocGroups.load(std::memory_order_relaxed)) {
+            allocGroups = neededGroups;
+            bufferClient.request();
+        }
+        
+        // The allocator sleeps until asked, so ask it to free buffers the
+        // last block swapped out
+        for (int g = 0; g < neededGroups; g++) {
+            if (leftDelay[g].hasRetiredBuffer() || rightDelay[g].hasRetiredBuffer() ||
+                tapeProcessor[g].hasRetiredBuffers()) {
+                bufferClient.request();
+                break;
+            }
+        }
+        
+        // Vocoder settings rebuild windows and clear buffers, so they reach
+        // the voices only when they change, or once for a newly built voice
+        int spectralReady = spectralVoicesReady.load(std::memory_order_acquire);
+        float sampleRate = allocSampleRate.load(std::memory_order_relaxed);
+        int fftSize = spectralFftSize.load(std::memory_order_relaxed);
+        int overlap = spectralOverlap.load(std::memory_order_relaxed);
+        bool background = spectralWorker.load(std::memory_order_relaxed);
+        if (sampleRate != spectralSampleRate || fftSize != spectralAppliedFftSize ||
+            overlap != spectralAppliedOverlap || background != spectralAppliedWorker) {
+            spectralSampleRate = sampleRate;
+            spectralAppliedFftSize = fftSize;
+            spectralAppliedOverlap = overlap;
+            spectralAppliedWorker = background;
+            spectralVoicesConfigured = 0;
+        }
+        for (int v = spectralVoicesConfigured; v < spectralReady; v++) {
+            SpectralVoice& voice = *spectralVoices[v];
+            voice.configure(sampleRate);
+            voice.setFrameSize(fftSize, overlap);
+            voice.setBackgroundProcessing(background);
+        }
+        spectralVoicesConfigured = spectralReady;
+    }
     
-    // Process pitch parameters with CV
-    processPitchParameters();
+    // Collect this frame into the input block, 4 voices per group
+    int groups = (channels + 3) / 4;
+    for (int g = 0; g < groups; g++) {
+        float_4 leftInput = inputs[LEFT_INPUT].getPolyVoltageSimd<float_4>(g * 4) * 0.1f; // Scale ±10V to ±1V
+        float_4 rightInput = inputs[RIGHT_INPUT].isConnected() ?
+                             inputs[RIGHT_INPUT].getPolyVoltageSimd<float_4>(g * 4) * 0.1f : leftInput;
+        blockInputL[g][blockPos] = leftInput;
+        blockInputR[g][blockPos] = rightInput;
+    }
     
-    // Process tape mode with full functionality
-    processTapeMode();
+    // Emit the matching frame of the previously processed block
+    outputs[LEFT_OUTPUT].setChannels(outputChannels);
+    outputs[RIGHT_OUTPUT].setChannels(outputChannels);
+    outputs[WET_LEFT_OUTPUT].setChannels(outputChannels);
+    outputs[WET_RIGHT_OUTPUT].setChannels(outputChannels);
+    for (int g = 0; g < (outputChannels + 3) / 4; g++) {
+        outputs[LEFT_OUTPUT].setVoltageSimd(blockOutputL[g][blockPos] * 10.0f, g * 4); // Scale back to ±10V
+        outputs[RIGHT_OUTPUT].setVoltageSimd(blockOutputR[g][blockPos] * 10.0f, g * 4);
+        outputs[WET_LEFT_OUTPUT].setVoltageSimd(blockWetL[g][blockPos] * 10.0f, g * 4);
+        outputs[WET_RIGHT_OUTPUT].setVoltageSimd(blockWetR[g][blockPos] * 10.0f, g * 4);
+    }
     
-    // Process tempo sync
-    processTempo();
+    // Level meters follow the first voice
+    float leftInput = blockInputL[0][blockPos][0];
+    float rightInput = blockInputR[0][blockPos][0];
     
-    // Process tap tempo
-    processTapTempo(args.sampleRate);
+    // Run every DSP stage over the whole block once it is full
+    if (++blockPos >= blockSize) {
+        processAudioBlock(blockSize);
+        outputChannels = channels;
+        blockPos = 0;
+    }
+    
+    // Update level meters and status lights
+    if (processCounter % LEVEL_UPDATE_RATE == 0) {
+        updateLevelMeters(leftInput * blockInputGain, rightInput * blockInputGain);
+        updateStatusLights();
+    }
+}
+
+// ===== BLOCK PROCESSING - COMPLETE SIGNAL FLOW =====
+void CurveAndDragModule::processAudioBlock(int n) {
+    // Refresh the parameter snapshot at control rate
+    controlFrames += n;
+    if (controlFrames >= CONTROL_RATE) {
+        updateParameterSnapshot();
+        applyParameterSnapshot(controlFrames);
+        controlFrames = 0;
+    }
+    const ParameterSnapshot& s = snapshot;
+    
+    // Shared gain and mix ramps; each group steps its own copy
+    inputGainRamp.setTarget(s.inputGain, n);
+    outputGainRamp.setTarget(s.outputGain, n);
+    outputMixRampL.setTarget(s.outputMixL, n);
+    outputMixRampR.setTarget(s.outputMixR, n);
+    float crossAmountTarget = clamp(s.crossFeedback * 0.3f, 0.0f, 0.3f); // Max 30%
+    crossAmountRamp.setTarget(crossAmountTarget, n);
+    
+    int groups = (channels + 3) / 4;
+    for (int g = 0; g < groups; g++) {
+        processVoiceGroup(g, n);
+    }
+    
+    // Every group has ramped to the new targets
+    inputGainRamp.reset(s.inputGain);
+    outputGainRamp.reset(s.outputGain);
+    outputMixRampL.reset(s.outputMixL);
+    outputMixRampR.reset(s.outputMixR);
+    crossAmountRamp.reset(crossAmountTarget);
+    blockInputGain = s.inputGain;
+}
+
+void CurveAndDragModule::processVoiceGroup(int g, int n) {
+    const ParameterSnapshot& s = snapshot;
+    float_4* inL = blockInputL[g].data();
+    float_4* inR = blockInputR[g].data();
+    float_4* procL = blockProcessL.data();
+    float_4* procR = blockProcessR.data();
     
-    // Get input signals
-    float leftInput = inputs[LEFT_INPUT].getVoltage() * 0.1f; // Scale ±10V to ±1V
-    float rightInput = inputs[RIGHT_INPUT].isConnected() ? 
-                      inputs[RIGHT_INPUT].getVoltage() * 0.1f : leftInput;
+    // Lanes past the last poly channel only carry silence
+    float_4 activeLanes = float_4(0.0f, 1.0f, 2.0f, 3.0f) + static_cast<float>(g * 4) < static_cast<float>(channels);
     
     // Apply input gain with CV modulation
-    float inputGain = getClampedParam(INPUT_GAIN_PARAM, INPUT_GAIN_CV_INPUT, 0.0f, 2.0f);
-    leftInput *= inputGain;
-    rightInput *= inputGain;
+    LinearRamp inputGainRamp = this->inputGainRamp;
+    for (int i = 0; i < n; i++) {
+        float gain = inputGainRamp.next();
+        inL[i] = simd::ifelse(activeLanes, inL[i] * gain, 0.0f);
+        inR[i] = simd::ifelse(activeLanes, inR[i] * gain, 0.0f);
+        procL[i] = inL[i];
+        procR[i] = inR[i];
+    }
     
     // ===== SIGNAL FLOW: Input → Pitch → Delay → Cross-feedback → Tape → Output =====
     
     // STEP 1: ===== CRITICAL FIX: Completely Rewritten Pitch Shifting System =====
-    float leftProcessed = leftInput;
-    float rightProcessed = rightInput;
-    
-    // Get pitch parameters with proper scaling
-    float basePitch = getClampedParam(PITCH_PARAM, PITCH_CV_INPUT, -2.0f, 2.0f) * 600.0f; // ±1200 cents
-    float detuneL = getClampedParam(DETUNE_L_PARAM, DETUNE_L_CV_INPUT, -1.0f, 1.0f) * 50.0f; // ±50 cents
-    float detuneR = getClampedParam(DETUNE_R_PARAM, DETUNE_R_CV_INPUT, -1.0f, 1.0f) * 50.0f; // ±50 cents
-    float detuneDrift = getClampedParam(DETUNE_DRIFT_PARAM, DETUNE_DRIFT_CV_INPUT, 0.0f, 1.0f) * 25.0f; // 0-25 cents
-    
-    // ===== CRITICAL FIX: Independent Left/Right Pitch Calculation =====
-    float leftFinalPitch = basePitch + detuneL + detuneDrift;
-    float rightFinalPitch = basePitch + detuneR - detuneDrift;
-    
-    // Apply quantization if enabled
-    if (params[QUANTIZE_PARAM].getValue() > 0.5f) {
-        lastRawPitch = basePitch;
+    
+    // ===== CRITICAL FIX: Independent Left/Right Pitch Calculation (per voice) =====
+    float_4 leftFinalPitch, rightFinalPitch;
+    for (int k = 0; k < 4; k++) {
+        int c = std::min(g * 4 + k, channels - 1);
+        float leftPitch = s.basePitch[c] + s.detuneL + s.detuneDrift;
+        float rightPitch = s.basePitch[c] + s.detuneR - s.detuneDrift;
         
-        if (params[MTS_ENABLE_PARAM].getValue() > 0.5f && mtsClient.isMtsConnected()) {
-            leftFinalPitch = quantizePitchMTS(leftFinalPitch);
-            rightFinalPitch = quantizePitchMTS(rightFinalPitch);
-            lastQuantizedPitch = leftFinalPitch;
-        } else {
-            int scaleIndex = clamp(static_cast<int>(params[SCALE_SELECT_PARAM].getValue()), 0, 10);
-            leftFinalPitch = quantizePitchBuiltIn(leftFinalPitch, scaleIndex);
-            rightFinalPitch = quantizePitchBuiltIn(rightFinalPitch, scaleIndex);
-            lastQuantizedPitch = leftFinalPitch;
+        // Apply quantization if enabled
+        if (s.quantize) {
+            leftPitch = quantizePitch(leftPitch);
+            rightPitch = quantizePitch(rightPitch);
         }
+        leftFinalPitch[k] = leftPitch;
+        rightFinalPitch[k] = rightPitch;
+    }
+    if (s.quantize && g == 0) {
+        lastRawPitch = s.basePitch[0];
+        lastQuantizedPitch = leftFinalPitch[0];
     }
     
+    // Convert cents to pitch ratios
+    float_4 leftRatioTarget = fastExp2(leftFinalPitch / 1200.0f);
+    float_4 rightRatioTarget = fastExp2(rightFinalPitch / 1200.0f);
+    
+    // ===== CRITICAL FIX: Automatic Gain Compensation =====
+    // Compensate for energy changes, clamped to prevent extreme values
+    float_4 leftGainCompTarget = simd::clamp(1.0f / simd::sqrt(simd::abs(leftRatioTarget)), 0.5f, 2.0f);
+    float_4 rightGainCompTarget = simd::clamp(1.0f / simd::sqrt(simd::abs(rightRatioTarget)), 0.5f, 2.0f);
+    
+    // Clamp ratios to prevent extreme pitch shifts (±1 octave max)
+    leftRatioTarget = simd::clamp(leftRatioTarget, 0.5f, 2.0f);
+    rightRatioTarget = simd::clamp(rightRatioTarget, 0.5f, 2.0f);
+    
+    // Voices without a shift on either side bypass the pitch stage
+    float_4 shiftedLanes = ((simd::abs(leftFinalPitch) > 1.0f) | (simd::abs(rightFinalPitch) > 1.0f)) & activeLanes;
+    
     // ===== CRITICAL FIX: Apply Pitch Shifting With Proper Gain Compensation =====
-    if (std::abs(leftFinalPitch) > 1.0f || std::abs(rightFinalPitch) > 1.0f) {
+    if (simd::movemask(shiftedLanes)) {
         // Get pitch mode and character
-        int pitchMode = clamp(static_cast<int>(params[PITCH_MODE_PARAM].getValue()), 0, 3);
-        float character = getClampedParam(CHARACTER_PARAM, CHARACTER_CV_INPUT, 0.0f, 1.0f);
-        
-        // Convert cents to pitch ratios
-        float leftRatio = std::pow(2.0f, leftFinalPitch / 1200.0f);
-        float rightRatio = std::pow(2.0f, rightFinalPitch / 1200.0f);
-        
-        // ===== CRITICAL FIX: Automatic Gain Compensation =====
-        float leftGainComp = 1.0f / std::sqrt(std::abs(leftRatio)); // Compensate for energy changes
-        float rightGainComp = 1.0f / std::sqrt(std::abs(rightRatio));
+        int pitchMode = s.pitchMode;
+        float character = s.character;
         
-        // Clamp compensation to prevent extreme values
-        leftGainComp = clamp(leftGainComp, 0.5f, 2.0f);
-        rightGainComp = clamp(rightGainComp, 0.5f, 2.0f);
+        // Ratios and compensation glide across the block
+        TLinearRamp<float_4>& ratioRampL = pitchRatioRampL[g];
+        TLinearRamp<float_4>& ratioRampR = pitchRatioRampR[g];
+        TLinearRamp<float_4>& compRampL = gainCompRampL[g];
+        TLinearRamp<float_4>& compRampR = gainCompRampR[g];
+        ratioRampL.setTarget(leftRatioTarget, n);
+        ratioRampR.setTarget(rightRatioTarget, n);
+        compRampL.setTarget(leftGainCompTarget, n);
+        compRampR.setTarget(rightGainCompTarget, n);
         
-        // Clamp ratios to prevent extreme pitch shifts
-        leftRatio = clamp(leftRatio, 0.5f, 2.0f); // ±1 octave max
-        rightRatio = clamp(rightRatio, 0.5f, 2.0f);
+        // ===== CRITICAL FIX: Functional Algorithm Selection (once per block) =====
+        PitchBlockControl control = {ratioRampL, ratioRampR, compRampL, compRampR,
+                                     leftRatioTarget, rightRatioTarget,
+                                     leftFinalPitch, rightFinalPitch, character};
+        PitchEngineGroup& engines = pitchEngines[g];
         
-        // ===== CRITICAL FIX: Functional Algorithm Selection =====
-        switch (pitchMode) {
-            case 0: // BBD (Bucket Brigade) - Analog delay-based pitch shifting
-                {
-                    static std::array<float, 8192> leftBBDBuffer = {};
-                    static std::array<float, 8192> rightBBDBuffer = {};
-                    static int bbdIndex = 0;
-                    static float leftBBDPhase = 0.0f;
-                    static float rightBBDPhase = 0.0f;
-                    
-                    // Write to buffers
-                    leftBBDBuffer[bbdIndex] = leftProcessed;
-                    rightBBDBuffer[bbdIndex] = rightProcessed;
-                    
-                    // Update read phases based on pitch ratios
-                    leftBBDPhase += 1.0f / leftRatio;
-                    rightBBDPhase += 1.0f / rightRatio;
-                    
-                    // Calculate read positions with modulo wrapping
-                    int leftReadPos = static_cast<int>(bbdIndex - leftBBDPhase) & 8191;
-                    int rightReadPos = static_cast<int>(bbdIndex - rightBBDPhase) & 8191;
-                    
-                    // Read with linear interpolation
-                    float leftFrac = leftBBDPhase - std::floor(leftBBDPhase);
-                    float rightFrac = rightBBDPhase - std::floor(rightBBDPhase);
-                    
-                    int leftReadPos2 = (leftReadPos + 1) & 8191;
-                    int rightReadPos2 = (rightReadPos + 1) & 8191;
-                    
-                    leftProcessed = (leftBBDBuffer[leftReadPos] * (1.0f - leftFrac) + 
-                                   leftBBDBuffer[leftReadPos2] * leftFrac) * leftGainComp;
-                    rightProcessed = (rightBBDBuffer[rightReadPos] * (1.0f - rightFrac) + 
-                                    rightBBDBuffer[rightReadPos2] * rightFrac) * rightGainComp;
-                    
-                    // Reset phases to prevent accumulation
-                    if (leftBBDPhase > 4096.0f) leftBBDPhase -= 4096.0f;
-                    if (rightBBDPhase > 4096.0f) rightBBDPhase -= 4096.0f;
-                    
-                    bbdIndex = (bbdIndex + 1) & 8191;
-                }
-                break;
+        // Time-domain engines get their buffers the first time they are
+        // used and pass dry until the allocator thread has built them
+        bool engineReady = pitchMode == PITCH_SPECTRAL || engines.publishBuffers(pitchMode);
+        if (!engineReady && !(allocPitchModes.load(std::memory_order_relaxed) & (1 << pitchMode))) {
+            allocPitchModes.fetch_or(1 << pitchMode, std::memory_order_relaxed);
+            bufferClient.request();
+        }
+        if (engineReady) {
+            switch (pitchMode) {
+                case PITCH_BBD: // Bucket Brigade - Analog delay-based pitch shifting
+                    engines.bbd.processBlock(procL, procR, n, control);
+                    break;
                 
-            case 1: // H910 (Harmonizer) - Windowed granular pitch shifting
-                {
-                    static std::array<float, 4096> leftH910Buffer = {};
-                    static std::array<float, 4096> rightH910Buffer = {};
-                    static int h910Index = 0;
-                    static float leftGrainPhase = 0.0f;
-                    static float rightGrainPhase = 0.0f;
-                    
-                    // Grain size based on pitch ratio for better quality
-                    int grainSize = clamp(static_cast<int>(512.0f / std::max(leftRatio, rightRatio)), 128, 1024);
-                    
-                    // Write to buffers
-                    leftH910Buffer[h910Index] = leftProcessed;
-                    rightH910Buffer[h910Index] = rightProcessed;
-                    
-                    // Generate Hann windows for smooth grains
-                    float leftWindow = 0.5f * (1.0f - std::cos(2.0f * M_PI * leftGrainPhase / grainSize));
-                    float rightWindow = 0.5f * (1.0f - std::cos(2.0f * M_PI * rightGrainPhase / grainSize));
-                    
-                    // Calculate read positions - CRITICAL FIX: Use proper ratio for pitch direction
-                    int leftReadIdx = static_cast<int>(h910Index - grainSize * leftRatio) & 4095;
-                    int rightReadIdx = static_cast<int>(h910Index - grainSize * rightRatio) & 4095;
-                    
-                    // Apply windowed grains with gain compensation
-                    leftProcessed = leftH910Buffer[leftReadIdx] * leftWindow * leftGainComp;
-                    rightProcessed = rightH910Buffer[rightReadIdx] * rightWindow * rightGainComp;
-                    
-                    // Update grain phases
-                    leftGrainPhase += 1.0f;
-                    rightGrainPhase += 1.0f;
-                    if (leftGrainPhase >= grainSize) leftGrainPhase = 0.0f;
-                    if (rightGrainPhase >= grainSize) rightGrainPhase = 0.0f;
-                    
-                    h910Index = (h910Index + 1) & 4095;
-                }
-                break;
+                case PITCH_H910: // Harmonizer - Windowed granular pitch shifting
+                    engines.h910.processBlock(procL, procR, n, control);
+                    break;
                 
-            case 2: // Varispeed (Tape-style) - Simple variable speed playback
-                {
-                    static std::array<float, 16384> leftVarBuffer = {};
-                    static std::array<float, 16384> rightVarBuffer = {};
-                    static float leftVarReadPos = 0.0f;
-                    static float rightVarReadPos = 0.0f;
-                    static int varWritePos = 0;
-                    
-                    // Write to buffers
-                    leftVarBuffer[varWritePos] = leftProcessed;
-                    rightVarBuffer[varWritePos] = rightProcessed;
-                    
-                    // Update read positions at modified speeds - CRITICAL FIX: Correct pitch direction
-                    leftVarReadPos += leftRatio;   // Higher ratio = faster read = higher pitch
-                    rightVarReadPos += rightRatio;
-                    
-                    // Calculate integer and fractional parts
-                    int leftReadInt = static_cast<int>(leftVarReadPos) & 16383;
-                    int rightReadInt = static_cast<int>(rightVarReadPos) & 16383;
-                    float leftFrac = leftVarReadPos - std::floor(leftVarReadPos);
-                    float rightFrac = rightVarReadPos - std::floor(rightVarReadPos);
-                    
-                    // Interpolated read with gain compensation
-                    int leftReadInt2 = (leftReadInt + 1) & 16383;
-                    int rightReadInt2 = (rightReadInt + 1) & 16383;
-                    
-                    leftProcessed = (leftVarBuffer[leftReadInt] * (1.0f - leftFrac) + 
-                                   leftVarBuffer[leftReadInt2] * leftFrac) * leftGainComp;
-                    rightProcessed = (rightVarBuffer[rightReadInt] * (1.0f - rightFrac) + 
-                                    rightVarBuffer[rightReadInt2] * rightFrac) * rightGainComp;
-                    
-                    // Wrap read positions
-                    if (leftVarReadPos >= 16384.0f) leftVarReadPos -= 16384.0f;
-                    if (rightVarReadPos >= 16384.0f) rightVarReadPos -= 16384.0f;
-                    
-                    varWritePos = (varWritePos + 1) & 16383;
-                }
-                break;
+                case PITCH_VARISPEED: // Tape-style variable speed playback
+                    engines.varispeed.processBlock(procL, procR, n, control);
+                    break;
                 
-            case 3: // Hybrid - Combines multiple techniques
-                {
-                    // Use H910 for small shifts, Varispeed for large shifts, BBD for character
-                    float leftPitchMag = std::abs(leftFinalPitch);
-                    float rightPitchMag = std::abs(rightFinalPitch);
-                    
-                    static std::array<float, 8192> leftHybridBuffer = {};
-                    static std::array<float, 8192> rightHybridBuffer = {};
-                    static int hybridIndex = 0;
-                    static float leftHybridPhase = 0.0f;
-                    static float rightHybridPhase = 0.0f;
-                    
-                    leftHybridBuffer[hybridIndex] = leftProcessed;
-                    rightHybridBuffer[hybridIndex] = rightProcessed;
-                    
-                    if (leftPitchMag < 100.0f && rightPitchMag < 100.0f) {
-                        // Small shifts: Use H910-style granular
-                        float window = 0.5f * (1.0f - std::cos(2.0f * M_PI * leftHybridPhase / 256.0f));
-                        int readIdx = static_cast<int>(hybridIndex - 256 / leftRatio) & 8191;
-                        leftProcessed = leftHybridBuffer[readIdx] * window * leftGainComp;
-                        
-                        window = 0.5f * (1.0f - std::cos(2.0f * M_PI * rightHybridPhase / 256.0f));
-                        readIdx = static_cast<int>(hybridIndex - 256 / rightRatio) & 8191;
-                        rightProcessed = rightHybridBuffer[readIdx] * window * rightGainComp;
-                        
-                        leftHybridPhase += 1.0f;
-                        rightHybridPhase += 1.0f;
-                        if (leftHybridPhase >= 256.0f) leftHybridPhase = 0.0f;
-                        if (rightHybridPhase >= 256.0f) rightHybridPhase = 0.0f;
-                    } else {
-                        // Large shifts: Use Varispeed with BBD coloration
-                        leftHybridPhase += 1.0f / leftRatio;
-                        rightHybridPhase += 1.0f / rightRatio;
-                        
-                        int leftReadIdx = static_cast<int>(hybridIndex - leftHybridPhase) & 8191;
-                        int rightReadIdx = static_cast<int>(hybridIndex - rightHybridPhase) & 8191;
-                        
-                        leftProcessed = leftHybridBuffer[leftReadIdx] * leftGainComp;
-                        rightProcessed = rightHybridBuffer[rightReadIdx] * rightGainComp;
-                        
-                        // Add BBD-style character
-                        leftProcessed = std::tanh(leftProcessed * (1.0f + character * 0.5f));
-                        rightProcessed = std::tanh(rightProcessed * (1.0f + character * 0.5f));
-                        
-                        if (leftHybridPhase > 4096.0f) leftHybridPhase -= 4096.0f;
-                        if (rightHybridPhase > 4096.0f) rightHybridPhase -= 4096.0f;
-                    }
-                    
-                    hybridIndex = (hybridIndex + 1) & 8191;
-                }
-                break;
+                case PITCH_HYBRID: // Granular for small shifts, varispeed for large ones
+                    engines.hybrid.processBlock(procL, procR, n, control);
+                    break;
+                
+                case PITCH_SPECTRAL: // Phase vocoder per voice, independent left/right
+                    processSpectralPitch(g, n, leftFinalPitch, rightFinalPitch);
+                    break;
+            }
         }
         
         // ===== CRITICAL FIX: Apply Character/Vintage Modeling Post-Pitch =====
-        if (character > 0.001f) {
+        // Runs oversampled; with oversampling on, the filters keep running
+        // at zero character and while bypassed (below) so the wet path
+        // latency does not jump
+        if (character > 0.001f || oversampling > 1) {
             // Add progressive saturation and filtering for vintage character
             float saturationAmount = 1.0f + character * 0.4f;
-            leftProcessed = std::tanh(leftProcessed * saturationAmount) / saturationAmount;
-            rightProcessed = std::tanh(rightProcessed * saturationAmount) / saturationAmount;
+            float bitReduction = character * 0.1f;
             
-            // Add subtle bit-crushing for digital vintage character
-            if (character > 0.3f) {
-                float bitReduction = character * 0.1f;
-                leftProcessed = std::round(leftProcessed / bitReduction) * bitReduction;
-                rightProcessed = std::round(rightProcessed / bitReduction) * bitReduction;
-            }
+            auto shapeCharacter = [=](float_4 x) {
+                if (character <= 0.001f) {
+                    return x;
+                }
+                x = fastTanh(x * saturationAmount) / saturationAmount;
+                
+                // Add subtle bit-crushing for digital vintage character
+                if (character > 0.3f) {
+                    x = simd::round(x / bitReduction) * bitReduction;
+                }
+                
+                // Add aliasing artifacts for vintage digital sound
+                if (character > 0.6f) {
+                    x += fastSin(x * 15.0f) * character * 0.01f;
+                }
+                return x;
+            };
             
-            // Add aliasing artifacts for vintage digital sound
-            if (character > 0.6f) {
-                leftProcessed += std::sin(leftProcessed * 15.0f) * character * 0.01f;
-                rightProcessed += std::sin(rightProcessed * 15.0f) * character * 0.01f;
+            for (int i = 0; i < n; i++) {
+                procL[i] = characterOversamplerL[g].process(procL[i], shapeCharacter);
+                procR[i] = characterOversamplerR[g].process(procR[i], shapeCharacter);
+            }
+        }
+        
+        // Unshifted voices in the group keep their dry signal
+        if (simd::movemask(shiftedLanes) != simd::movemask(activeLanes)) {
+            for (int i = 0; i < n; i++) {
+                procL[i] = simd::ifelse(shiftedLanes, procL[i], inL[i]);
+                procR[i] = simd::ifelse(shiftedLanes, procR[i], inR[i]);
             }
         }
+    } else {
+        // Bypassed: start the next shifted block from the current settings
+        pitchRatioRampL[g].reset(leftRatioTarget);
+        pitchRatioRampR[g].reset(rightRatioTarget);
+        gainCompRampL[g].reset(leftGainCompTarget);
+        gainCompRampR[g].reset(rightGainCompTarget);
+        
+        // With oversampling on, the character filters keep running on the
+        // dry signal so the wet path latency stays the same when a lane
+        // starts shifting again; otherwise they restart empty
+        if (oversampling > 1) {
+            auto identity = [](float_4 x) { return x; };
+            for (int i = 0; i < n; i++) {
+                procL[i] = characterOversamplerL[g].process(procL[i], identity);
+                procR[i] = characterOversamplerR[g].process(procR[i], identity);
+            }
+        } else {
+            characterOversamplerL[g].reset();
+            characterOversamplerR[g].reset();
+        }
     }
     
     // STEP 2: Process through delay lines
-    float leftDelayed = leftDelay.process(leftProcessed);
-    float rightDelayed = rightDelay.process(rightProcessed);
+    leftDelay[g].processBlock(procL, procL, n);
+    rightDelay[g].processBlock(procR, procR, n);
     
     // STEP 3: ===== CRITICAL FIX: Enhanced Cross-Feedback System (BEFORE Tape Processing) =====
-    if (params[CROSS_FEEDBACK_PARAM].getValue() > 0.01f) {
-        float crossAmount = clamp(params[CROSS_FEEDBACK_PARAM].getValue() * 0.3f, 0.0f, 0.3f); // Max 30%
+    if (s.crossFeedback > 0.01f) {
+        LinearRamp crossAmountRamp = this->crossAmountRamp;
         
-        // Store previous delayed values to prevent infinite feedback
-        static float prevLeftDelayed = 0.0f;
-        static float prevRightDelayed = 0.0f;
-        static float leftCrossFilter = 0.0f;
-        static float rightCrossFilter = 0.0f;
+        // Previous delayed values are kept to prevent infinite feedback
+        CrossFeedbackState& cross = crossFeedback[g];
         
         // Apply filtering to cross-feedback to prevent harsh resonances
         float filterCoeff = 0.8f; // Low-pass the cross-feedback
-        leftCrossFilter += (prevRightDelayed - leftCrossFilter) * filterCoeff;
-        rightCrossFilter += (prevLeftDelayed - rightCrossFilter) * filterCoeff;
-        
-        // ===== CRITICAL FIX: Apply cross-feedback regardless of tape mode =====
-        // Calculate cross-feedback using filtered previous values
-        float leftCross = leftDelayed + leftCrossFilter * crossAmount;
-        float rightCross = rightDelayed + rightCrossFilter * crossAmount;
         
-        // Apply progressive soft limiting to prevent runaway feedback
-        leftDelayed = std::tanh(leftCross * 0.7f) / 0.7f;
-        rightDelayed = std::tanh(rightCross * 0.7f) / 0.7f;
-        
-        // Update previous values for next sample (CRITICAL: Update AFTER tape processing)
-        // This ensures cross-feedback works with tape effects
-        prevLeftDelayed = leftDelayed;
-        prevRightDelayed = rightDelayed;
+        for (int i = 0; i < n; i++) {
+            float crossAmount = crossAmountRamp.next();
+            cross.leftFilter += (cross.prevRight - cross.leftFilter) * filterCoeff;
+            cross.rightFilter += (cross.prevLeft - cross.rightFilter) * filterCoeff;
+            
+            // ===== CRITICAL FIX: Apply cross-feedback regardless of tape mode =====
+            // Calculate cross-feedback using filtered previous values
+            float_4 leftCross = procL[i] + cross.leftFilter * crossAmount;
+            float_4 rightCross = procR[i] + cross.rightFilter * crossAmount;
+            
+            // Apply progressive soft limiting to prevent runaway feedback
+            procL[i] = fastTanh(leftCross * 0.7f) / 0.7f;
+            procR[i] = fastTanh(rightCross * 0.7f) / 0.7f;
+            
+            // Update previous values for next sample
+            cross.prevLeft = procL[i];
+            cross.prevRight = procR[i];
+        }
     }
     
     // STEP 4: ===== CRITICAL FIX: Enhanced Tape Processing (AFTER Cross-Feedback) =====
-    bool tapeEnabled = params[TAPE_MODE_PARAM].getValue() > 0.5f;
+    // (runs while the processor fades out after tape mode is switched off)
+    if (tapeProcessor[g].isTapeActive()) {
+        // Process through tape emulation; noise is injected inside the processor
+        tapeProcessor[g].processBlock(procL, procR, procL, procR, n);
+    }
     
-    if (tapeEnabled) {
-        // Process through tape emulation with proper configuration
-        float leftTaped = tapeProcessor.process(leftDelayed, 0);  // Left channel
-        float rightTaped = tapeProcessor.process(rightDelayed, 1); // Right channel
+    // STEP 5: Apply output mixing and gain
+    LinearRamp outputGainRamp = this->outputGainRamp;
+    LinearRamp outputMixRampL = this->outputMixRampL;
+    LinearRamp outputMixRampR = this->outputMixRampR;
+    
+    for (int i = 0; i < n; i++) {
+        float outputGain = outputGainRamp.next();
+        float leftMix = outputMixRampL.next();
+        float rightMix = outputMixRampR.next();
         
-        // ===== CRITICAL FIX: Tape noise is now handled internally by TapeDelayProcessor =====
-        // No need to inject noise here as it's already done in tapeProcessor.process()
+        // Mix dry and wet signals based on mix parameters
+        float_4 leftOutput = (inL[i] * (1.0f - leftMix) + procL[i] * leftMix) * outputGain;
+        float_4 rightOutput = (inR[i] * (1.0f - rightMix) + procR[i] * rightMix) * outputGain;
         
-        // Update delayed signals with tape processing
-        leftDelayed = leftTaped;
-        rightDelayed = rightTaped;
+        // Final safety limiting
+        blockOutputL[g][i] = simd::clamp(leftOutput, -5.0f, 5.0f);
+        blockOutputR[g][i] = simd::clamp(rightOutput, -5.0f, 5.0f);
         
-        // ===== CRITICAL FIX: Update cross-feedback state AFTER tape processing =====
-        // This ensures the cross-feedback path includes tape coloration
-        if (params[CROSS_FEEDBACK_PARAM].getValue() > 0.01f) {
-            // Store the tape-processed signal for cross-feedback on next sample
-            static float prevLeftTaped = 0.0f;
-            static float prevRightTaped = 0.0f;
-            prevLeftTaped = leftDelayed;
-            prevRightTaped = rightDelayed;
-        }
-    }
-    
-    // STEP 5: Apply output mixing and gain
-    float outputGain = getClampedParam(OUTPUT_GAIN_PARAM, OUTPUT_GAIN_CV_INPUT, 0.0f, 2.0f);
-    
-    // Mix dry and wet signals based on mix parameters
-    float leftMix = clamp(params[MIX_L_PARAM].getValue(), 0.0f, 1.0f);
-    float rightMix = clamp(params[MIX_R_PARAM].getValue(), 0.0f, 1.0f);
-    
-    float leftOutput = (leftInput * (1.0f - leftMix) + leftDelayed * leftMix) * outputGain;
-    float rightOutput = (rightInput * (1.0f - rightMix) + rightDelayed * rightMix) * outputGain;
-    
-    // Final safety limiting
-    leftOutput = clamp(leftOutput, -5.0f, 5.0f);
-    rightOutput = clamp(rightOutput, -5.0f, 5.0f);
-    
-    // Set outputs
-    outputs[LEFT_OUTPUT].setVoltage(leftOutput * 10.0f); // Scale back to ±10V
-    outputs[RIGHT_OUTPUT].setVoltage(rightOutput * 10.0f);
-    
-    // Wet-only outputs
-    outputs[WET_LEFT_OUTPUT].setVoltage(leftDelayed * outputGain * 10.0f);
-    outputs[WET_RIGHT_OUTPUT].setVoltage(rightDelayed * outputGain * 10.0f);
-    
-    // Update level meters and status lights
-    if (processCounter % LEVEL_UPDATE_RATE == 0) {
-        updateLevelMeters(leftInput, rightInput);
-        updateStatusLights();
+        // Wet-only outputs
+        blockWetL[g][i] = procL[i] * outputGain;
+        blockWetR[g][i] = procR[i] * outputGain;
     }
 }
 
 // ===== HELPER METHODS =====
-void CurveAndDragModule::processDelayParameters(float sampleRate) {
-    // Process left delay time with global modulation
-    if (!params[SYNC_L_PARAM].getValue()) { // Only if not tempo synced
-        float leftTimeBase = getClampedParam(TIME_L_PARAM, TIME_L_CV_INPUT, 0.0f, 1.0f) * 2000.0f;
-        float leftTimeMs = leftTimeBase + (timeCVGlobal * 100.0f); // ±100ms modulation
-        leftDelay.setDelayTime(clamp(leftTimeMs, 1.0f, 2000.0f));
-    }
-    
-    // Process right delay time with global modulation
-    if (!params[SYNC_R_PARAM].getValue()) { // Only if not tempo synced
-        float rightTimeBase = getClampedParam(TIME_R_PARAM, TIME_R_CV_INPUT, 0.0f, 1.0f) * 2000.0f;
-        float rightTimeMs = rightTimeBase + (timeCVGlobal * 100.0f);
-        rightDelay.setDelayTime(clamp(rightTimeMs, 1.0f, 2000.0f));
-    }
-    
-    // Process feedback amounts with global modulation
-    if (!inputs[FEEDBACK_L_CV_INPUT].isConnected()) {
-        float leftFeedback = params[FEEDBACK_L_PARAM].getValue();
-        leftFeedback += feedbackCVGlobal * 0.1f; // ±10% modulation
-        leftDelay.setFeedback(clamp(leftFeedback, 0.0f, 1.1f));
-    }
-    
-    if (!inputs[FEEDBACK_R_CV_INPUT].isConnected()) {
-        float rightFeedback = params[FEEDBACK_R_PARAM].getValue();
-        rightFeedback += feedbackCVGlobal * 0.1f;
-        rightDelay.setFeedback(clamp(rightFeedback, 0.0f, 1.1f));
-    }
-    
-    // Process mix amounts (if not overridden by CV)
-    if (!inputs[MIX_L_CV_INPUT].isConnected()) {
-        float leftMix = params[MIX_L_PARAM].getValue();
-        leftDelay.setDryWet(leftMix);
-    }
-    
-    if (!inputs[MIX_R_CV_INPUT].isConnected()) {
-        float rightMix = params[MIX_R_PARAM].getValue();
-        rightDelay.setDryWet(rightMix);
+void CurveAndDragModule::processDelayParameters() {
+    const ParameterSnapshot& s = snapshot;
+    
+    int groups = (channels + 3) / 4;
+    for (int g = 0; g < groups; g++) {
+        // Delay times with global modulation (tempo sync sets them in processTempo)
+        if (!s.syncL) {
+            leftDelay[g].setDelayTime(simd::clamp(float_4::load(&s.timeL[g * 4]), 1.0f, 2000.0f));
+        }
+        if (!s.syncR) {
+            rightDelay[g].setDelayTime(simd::clamp(float_4::load(&s.timeR[g * 4]), 1.0f, 2000.0f));
+        }
+        
+        // Feedback amounts with per-channel or global modulation
+        leftDelay[g].setFeedback(float_4::load(&s.feedbackL[g * 4]));
+        rightDelay[g].setFeedback(float_4::load(&s.feedbackR[g * 4]));
+        
+        // Mix amounts with CV
+        leftDelay[g].setDryWet(s.delayMixL);
+        rightDelay[g].setDryWet(s.delayMixR);
     }
 }
 
@@ -815,83 +890,112 @@ void CurveAndDragModule::processTapTempo(float sampleRate) {
     }
 }
 
+// ===== SPECTRAL PITCH MODE =====
+void CurveAndDragModule::processSpectralPitch(int g, int n, float_4 leftCents, float_4 rightCents) {
+    float_4* procL = blockProcessL.data();
+    float_4* procR = blockProcessR.data();
+    // Frame size, overlap and sample rate were applied on the block boundary
+    int ready = spectralVoicesConfigured;
+    bool phaseLocking = spectralPhaseLocking.load(std::memory_order_relaxed);
+    const ParameterSnapshot& s = snapshot;
+    
+    // Harmony voices sit at fixed intervals from each voice's unquantized
+    // left/right pitch and are quantized like the voice itself
+    float intervals[PitchShifter::MAX_HARMONY_VOICES];
+    int harmonyCount = getHarmonyIntervals(spectralHarmony.load(std::memory_order_relaxed), intervals);
+    float harmonyL[PitchShifter::MAX_HARMONY_VOICES];
+    float harmonyR[PitchShifter::MAX_HARMONY_VOICES];
+    
+    // The vocoders are scalar: each voice's lane is processed on its own
+    float laneL[MAX_BLOCK_SIZE];
+    float laneR[MAX_BLOCK_SIZE];
+    for (int k = 0; k < 4; k++) {
+        int c = g * 4 + k;
+        if (c >= channels || c >= ready) {
+            // Not built yet: the voice stays dry until the allocator catches up
+            continue;
+        }
+        SpectralVoice& voice = *spectralVoices[c];
+        voice.setPhaseLocking(phaseLocking);
+        voice.left.setPitchShiftCents(clamp(leftCents[k], -1200.0f, 1200.0f));
+        voice.right.setPitchShiftCents(clamp(rightCents[k], -1200.0f, 1200.0f));
+        for (int v = 0; v < harmonyCount; v++) {
+            harmonyL[v] = s.basePitch[c] + s.detuneL + s.detuneDrift + intervals[v];
+            harmonyR[v] = s.basePitch[c] + s.detuneR - s.detuneDrift + intervals[v];
+            if (s.quantize) {
+                harmonyL[v] = quantizePitch(harmonyL[v]);
+                harmonyR[v] = quantizePitch(harmonyR[v]);
+            }
+        }
+        voice.left.setHarmonyCents(harmonyL, harmonyCount);
+        voice.right.setHarmonyCents(harmonyR, harmonyCount);
+        
+        for (int i = 0; i < n; i++) {
+            laneL[i] = procL[i][k];
+            laneR[i] = procR[i][k];
+        }
+        voice.processBlock(laneL, laneR, laneL, laneR, n);
+        for (int i = 0; i < n; i++) {
+            procL[i][k] = laneL[i];
+            procR[i][k] = laneR[i];
+        }
+    }
+}
+
 // ===== v2.8.0 COMPLETE PITCH PROCESSING WITH QUANTIZATION =====
-void CurveAndDragModule::processPitchParameters() {
+void CurveAndDragModule::processPitchParameters(int frames) {
+    const ParameterSnapshot& s = snapshot;
+    
     // ===== CRITICAL FIX: Proper pitch parameter range and smoothing =====
-    float basePitch = getClampedParam(PITCH_PARAM, PITCH_CV_INPUT, -2.0f, 2.0f) * 600.0f; // ±1200 cents
+    float basePitch = s.basePitch[0]; // ±1200 cents, first voice drives the display
     
-    // Static smoothing states for anti-click protection
-    static float smoothedBasePitch = 0.0f;
-    static float smoothedDetuneL = 0.0f;
-    static float smoothedDetuneR = 0.0f;
-    static float smoothedDrift = 0.0f;
+    // Per-sample smoothing rates applied once for the whole control period
+    auto periodRate = [frames](float perSampleRate) {
+        return 1.0f - std::pow(1.0f - perSampleRate, static_cast<float>(frames));
+    };
+    
+    // Smoothing states for anti-click protection
+    float& smoothedBasePitch = pitchSmoothing.basePitch;
+    float& smoothedDetuneL = pitchSmoothing.detuneL;
+    float& smoothedDetuneR = pitchSmoothing.detuneR;
+    float& smoothedDrift = pitchSmoothing.drift;
     
     // ===== CRITICAL FIX: Exponential smoothing with large jump detection =====
     float pitchDiff = std::abs(basePitch - smoothedBasePitch);
     float smoothingRate = (pitchDiff > 50.0f) ? 0.0005f : 0.002f; // Slower for large jumps
     
     // Apply pitch smoothing with maximum change rate limiting
-    float maxChange = 25.0f; // Maximum cents change per sample
+    float maxChange = 25.0f * frames; // Maximum 25 cents change per sample
     float pitchChange = basePitch - smoothedBasePitch;
     pitchChange = clamp(pitchChange, -maxChange, maxChange);
-    smoothedBasePitch += pitchChange * smoothingRate;
-    
-    // Process detune parameters with proper scaling
-    float detuneL = getClampedParam(DETUNE_L_PARAM, DETUNE_L_CV_INPUT, -1.0f, 1.0f) * 50.0f; // ±50 cents
-    float detuneR = getClampedParam(DETUNE_R_PARAM, DETUNE_R_CV_INPUT, -1.0f, 1.0f) * 50.0f; // ±50 cents
-    float detuneDrift = getClampedParam(DETUNE_DRIFT_PARAM, DETUNE_DRIFT_CV_INPUT, 0.0f, 1.0f) * 25.0f; // 0-25 cents
+    smoothedBasePitch += pitchChange * periodRate(smoothingRate);
     
     // Smooth detune parameters
-    smoothedDetuneL += (detuneL - smoothedDetuneL) * 0.01f;
-    smoothedDetuneR += (detuneR - smoothedDetuneR) * 0.01f;
-    smoothedDrift += (detuneDrift - smoothedDrift) * 0.005f;
+    smoothedDetuneL += (s.detuneL - smoothedDetuneL) * periodRate(0.01f);
+    smoothedDetuneR += (s.detuneR - smoothedDetuneR) * periodRate(0.01f);
+    smoothedDrift += (s.detuneDrift - smoothedDrift) * periodRate(0.005f);
     
     // ===== CRITICAL FIX: Safe quantization with clipping =====
-    if (params[QUANTIZE_PARAM].getValue() > 0.5f) {
+    if (s.quantize) {
         lastRawPitch = smoothedBasePitch;
         
         // Clamp input pitch to safe range before quantization
         float clampedPitch = clamp(smoothedBasePitch, -1200.0f, 1200.0f);
         
-        if (params[MTS_ENABLE_PARAM].getValue() > 0.5f && mtsClient.isMtsConnected()) {
-            lastQuantizedPitch = quantizePitchMTS(clampedPitch);
-        } else {
-            int scaleIndex = clamp(static_cast<int>(params[SCALE_SELECT_PARAM].getValue()), 0, 10);
-            lastQuantizedPitch = quantizePitchBuiltIn(clampedPitch, scaleIndex);
-        }
+        lastQuantizedPitch = quantizePitch(clampedPitch);
         
         // ===== CRITICAL FIX: Smooth quantized pitch transition to prevent spikes =====
         float quantDiff = lastQuantizedPitch - smoothedBasePitch;
-        float maxQuantChange = 100.0f; // Maximum 100 cents change per sample
+        float maxQuantChange = 100.0f; // Maximum 100 cents change per update
         quantDiff = clamp(quantDiff, -maxQuantChange, maxQuantChange);
-        smoothedBasePitch += quantDiff * 0.1f; // Slow transition to quantized pitch
+        smoothedBasePitch += quantDiff * periodRate(0.1f); // Slow transition to quantized pitch
     }
     
-    // Apply final pitch to pitch shifter with detune and drift
-    float leftFinalPitch = smoothedBasePitch + smoothedDetuneL + smoothedDrift;
-    float rightFinalPitch = smoothedBasePitch + smoothedDetuneR - smoothedDrift * 0.5f;
-    
-    // ===== CRITICAL FIX: Clamp final pitch values to prevent feedback =====
-    leftFinalPitch = clamp(leftFinalPitch, -1200.0f, 1200.0f);
-    rightFinalPitch = clamp(rightFinalPitch, -1200.0f, 1200.0f);
-    
-    // Set pitch mode from parameter
-    int pitchModeIndex = static_cast<int>(params[PITCH_MODE_PARAM].getValue());
-    int pitchMode = clamp(pitchModeIndex, 0, 3);
-    
-    // Get character parameter for vintage modeling
-    float character = getClampedParam(CHARACTER_PARAM, CHARACTER_CV_INPUT, 0.0f, 1.0f);
-    
-    // Configure pitch shifter with correct method calls
-    // Use average of left/right pitch since pitch shifter processes single values
-    float avgPitch = (leftFinalPitch + rightFinalPitch) * 0.5f;
-    pitchShifter.setPitchShiftCents(avgPitch);
-    pitchShifter.setCharacter(character);
-    pitchShifter.setPitchMode(pitchMode);
-    
-    // Set detune drift for stereo movement
-    float driftRate = 0.1f + smoothedDrift * 0.01f; // 0.1-0.6 Hz drift rate
-    pitchShifter.setDetuneDrift(smoothedDrift * 0.01f, driftRate);
+    // Spectral mode: have the allocator build vocoders for every voice
+    if (s.pitchMode == PITCH_SPECTRAL && allocSpectralVoices.load(std::memory_order_relaxed) < channels) {
+        allocSpectralVoices = channels;
+        bufferClient.request();
+    }
     
     // Store the left/right detune values for independent channel processing
     lastDetuneL = smoothedDetuneL;
@@ -899,6 +1003,14 @@ void CurveAndDragModule::processPitchParameters() {
 }
 
 // ===== v2.8.0 QUANTIZATION METHODS =====
+float CurveAndDragModule::quantizePitch(float pitchCents) {
+    const ParameterSnapshot& s = snapshot;
+    if (s.mtsEnabled && mtsClient.isMtsConnected()) {
+        return quantizePitchMTS(pitchCents);
+    }
+    return quantizePitchBuiltIn(pitchCents, s.scaleIndex);
+}
+
 float CurveAndDragModule::quantizePitchMTS(float pitchCents) {
     // Convert cents to MIDI note
     float midiNote = 60.0f + pitchCents / 100.0f; // C4 = 60 + cents offset
@@ -926,8 +1038,8 @@ float CurveAndDragModule::quantizePitchBuiltIn(float pitchCents, int scaleIndex)
         case 3: // Just Intonation
             {
                 // Simple just intonation ratios
-                std::vector<float> justRatios = {1.0f, 16.0f/15.0f, 9.0f/8.0f, 6.0f/5.0f, 5.0f/4.0f, 4.0f/3.0f, 
-                                               45.0f/32.0f, 3.0f/2.0f, 8.0f/5.0f, 5.0f/3.0f, 9.0f/5.0f, 15.0f/8.0f};
+                static const std::array<float, 12> justRatios = {1.0f, 16.0f/15.0f, 9.0f/8.0f, 6.0f/5.0f, 5.0f/4.0f, 4.0f/3.0f,
+                                                                 45.0f/32.0f, 3.0f/2.0f, 8.0f/5.0f, 5.0f/3.0f, 9.0f/5.0f, 15.0f/8.0f};
                 
                 float semitones = pitchCents / 100.0f;
                 int octave = static_cast<int>(semitones / 12.0f);
@@ -942,8 +1054,8 @@ float CurveAndDragModule::quantizePitchBuiltIn(float pitchCents, int scaleIndex)
         case 4: // Pythagorean
             {
                 // Pythagorean tuning based on 3:2 ratios
-                std::vector<float> pythRatios = {1.0f, 256.0f/243.0f, 9.0f/8.0f, 32.0f/27.0f, 81.0f/64.0f, 4.0f/3.0f,
-                                               729.0f/512.0f, 3.0f/2.0f, 128.0f/81.0f, 27.0f/16.0f, 16.0f/9.0f, 243.0f/128.0f};
+                static const std::array<float, 12> pythRatios = {1.0f, 256.0f/243.0f, 9.0f/8.0f, 32.0f/27.0f, 81.0f/64.0f, 4.0f/3.0f,
+                                                                 729.0f/512.0f, 3.0f/2.0f, 128.0f/81.0f, 27.0f/16.0f, 16.0f/9.0f, 243.0f/128.0f};
                 
                 float semitones = pitchCents / 100.0f;
                 int octave = static_cast<int>(semitones / 12.0f);
@@ -1061,11 +1173,11 @@ void CurveAndDragModule::updateStatusLights() {
     lights[MORPH_LIGHT].setBrightness(morphAmount);
 }
 
-float CurveAndDragModule::getClampedParam(int paramId, int cvInputId, float minVal, float maxVal, float defaultVal) {
+float CurveAndDragModule::getClampedParam(int paramId, int cvInputId, float minVal, float maxVal, float defaultVal, int channel) {
     float paramValue = params[paramId].getValue();
     
     if (cvInputId >= 0 && inputs[cvInputId].isConnected()) {
-        float cvValue = inputs[cvInputId].getVoltage() / 10.0f; // Normalize ±10V to ±1
+        float cvValue = inputs[cvInputId].getPolyVoltage(channel) / 10.0f; // Normalize ±10V to ±1
         float range = maxVal - minVal;
         paramValue += cvValue * range * 0.1f; // ±10% CV modulation
     }
@@ -1082,6 +1194,16 @@ json_t* CurveAndDragModule::dataToJson() {
     json_object_set_new(rootJ, "tuningInfo", json_string(tuningInfo.c_str()));
     json_object_set_new(rootJ, "detectedBPM", json_real(detectedBPM));
     
+    // Save processing options
+    json_object_set_new(rootJ, "blockSize", json_integer(getBlockSize()));
+    json_object_set_new(rootJ, "delayInterpolation", json_integer(getDelayInterpolation()));
+    json_object_set_new(rootJ, "oversampling", json_integer(getOversampling()));
+    json_object_set_new(rootJ, "spectralWorker", json_boolean(getSpectralWorker()));
+    json_object_set_new(rootJ, "spectralFftSize", json_integer(getSpectralFftSize()));
+    json_object_set_new(rootJ, "spectralOverlap", json_integer(getSpectralOverlap()));
+    json_object_set_new(rootJ, "spectralHarmony", json_integer(getSpectralHarmony()));
+    json_object_set_new(rootJ, "spectralPhaseLocking", json_boolean(getSpectralPhaseLocking()));
+    
     return rootJ;
 }
 
@@ -1101,6 +1223,45 @@ void CurveAndDragModule::dataFromJson(json_t* rootJ) {
     if (bpmJ) {
         detectedBPM = json_real_value(bpmJ);
     }
+    
+    json_t* blockSizeJ = json_object_get(rootJ, "blockSize");
+    if (blockSizeJ) {
+        setBlockSize(json_integer_value(blockSizeJ));
+    }
+    
+    json_t* interpolationJ = json_object_get(rootJ, "delayInterpolation");
+    if (interpolationJ) {
+        setDelayInterpolation(json_integer_value(interpolationJ));
+    }
+    
+    // Patches saved before the option existed keep their original latency
+    json_t* oversamplingJ = json_object_get(rootJ, "oversampling");
+    setOversampling(oversamplingJ ? json_integer_value(oversamplingJ) : 1);
+    
+    json_t* spectralWorkerJ = json_object_get(rootJ, "spectralWorker");
+    if (spectralWorkerJ) {
+        setSpectralWorker(json_boolean_value(spectralWorkerJ));
+    }
+    
+    json_t* spectralFftSizeJ = json_object_get(rootJ, "spectralFftSize");
+    if (spectralFftSizeJ) {
+        setSpectralFftSize(json_integer_value(spectralFftSizeJ));
+    }
+    
+    json_t* spectralOverlapJ = json_object_get(rootJ, "spectralOverlap");
+    if (spectralOverlapJ) {
+        setSpectralOverlap(json_integer_value(spectralOverlapJ));
+    }
+    
+    json_t* spectralHarmonyJ = json_object_get(rootJ, "spectralHarmony");
+    if (spectralHarmonyJ) {
+        setSpectralHarmony(json_integer_value(spectralHarmonyJ));
+    }
+    
+    json_t* spectralPhaseLockingJ = json_object_get(rootJ, "spectralPhaseLocking");
+    if (spectralPhaseLockingJ) {
+        setSpectralPhaseLocking(json_boolean_value(spectralPhaseLockingJ));
+    }
 }
 
 // ===== MISSING HELPER METHODS =====
@@ -1111,24 +1272,27 @@ void CurveAndDragModule::processTapeParameters() {
     // Update head delay times based on head configuration and tempo sync
     if (params[TAPE_MODE_PARAM].getValue() > 0.5f) {
         float baseDelayTime = 100.0f; // Base delay in ms
+        float_4 headDelayTimes;
         
-        for (int ch = 0; ch < 2; ch++) {
-            for (int head = 0; head < 4; head++) {
-                float headDelayTime = baseDelayTime + (head * 50.0f);
-                
-                // Apply tempo sync if enabled for this channel
-                bool syncEnabled = (ch == 0) ? params[SYNC_L_PARAM].getValue() > 0.5f : params[SYNC_R_PARAM].getValue() > 0.5f;
-                if (syncEnabled) {
-                    int subdivIndex = (ch == 0) ? static_cast<int>(params[SUBDIV_L_PARAM].getValue()) : static_cast<int>(params[SUBDIV_R_PARAM].getValue());
-                    SubdivisionType subdivType = static_cast<SubdivisionType>(clamp(subdivIndex, 0, 5));
-                    float subdivMultiplier = getSubdivisionMultiplier(subdivType);
-                    
-                    float beatTimeMs = (60.0f / detectedBPM) * 1000.0f;
-                    headDelayTime = beatTimeMs * subdivMultiplier * (1.0f + head * 0.1f); // Slight offset per head
-                }
+        // Both channels' tape loops share the head positions, so they follow the left sync settings
+        for (int head = 0; head < 4; head++) {
+            float headDelayTime = baseDelayTime + (head * 50.0f);
+            
+            // Apply tempo sync if enabled
+            if (params[SYNC_L_PARAM].getValue() > 0.5f) {
+                int subdivIndex = static_cast<int>(params[SUBDIV_L_PARAM].getValue());
+                SubdivisionType subdivType = static_cast<SubdivisionType>(clamp(subdivIndex, 0, 5));
+                float subdivMultiplier = getSubdivisionMultiplier(subdivType);
                 
-                tapeProcessor.playHeads[ch][head].setDelayTime(clamp(headDelayTime, 1.0f, 2000.0f));
+                float beatTimeMs = (60.0f / detectedBPM) * 1000.0f;
+                headDelayTime = beatTimeMs * subdivMultiplier * (1.0f + head * 0.1f); // Slight offset per head
             }
+            
+            headDelayTimes[head] = clamp(headDelayTime, 1.0f, 2000.0f);
+        }
+        
+        for (auto& tape : tapeProcessor) {
+            tape.setHeadDelayTimes(headDelayTimes);
         }
     }
 }
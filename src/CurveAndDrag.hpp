@@ -6,17 +6,84 @@
 #include "ScalaReader.hpp"
 #include "TapeDelayProcessor.hpp"
 #include "MTS_ESP.hpp"
+#include "Oversampler.hpp"
+#include "LinearRamp.hpp"
+#include "FastMath.hpp"
+#include "SimdUtils.hpp"
+#include "PitchEngines.hpp"
+#include "BackgroundAllocator.hpp"
+#include <array>
+#include <atomic>
+#include <memory>
 
 using namespace rack;
 
 namespace CurveAndDrag {
 
+/**
+ * @brief Control-rate snapshot of every parameter and CV input
+ * 
+ * Filled once per control period so the audio path never reads params[]
+ * or inputs[] itself. Values are already scaled, CV-modulated and clamped.
+ * Arrays hold one value per poly voice for inputs that accept poly CV.
+ */
+struct ParameterSnapshot {
+    // Delay
+    std::array<float, PORT_MAX_CHANNELS> timeL = {};     // ms, including global time modulation
+    std::array<float, PORT_MAX_CHANNELS> timeR = {};
+    std::array<float, PORT_MAX_CHANNELS> feedbackL = {}; // 0.0-1.1
+    std::array<float, PORT_MAX_CHANNELS> feedbackR = {};
+    float delayMixL = 0.5f;         // Delay line dry/wet
+    float delayMixR = 0.5f;
+    float outputMixL = 0.5f;        // Output dry/wet
+    float outputMixR = 0.5f;
+    bool syncL = false;
+    bool syncR = false;
+    int subdivL = 2;
+    int subdivR = 2;
+    float crossFeedback = 0.0f;     // Raw switch/knob value
+    float inputGain = 1.0f;
+    float outputGain = 1.0f;
+    
+    // Pitch
+    std::array<float, PORT_MAX_CHANNELS> basePitch = {}; // cents
+    float detuneL = 0.0f;           // cents
+    float detuneR = 0.0f;           // cents
+    float detuneDrift = 0.0f;       // cents
+    float character = 0.5f;
+    float morph = 0.0f;
+    int pitchMode = 1;
+    bool quantize = false;
+    bool mtsEnabled = false;
+    int scaleIndex = 0;
+    
+    // Tape
+    bool tapeMode = false;
+    float wowRate = 0.3f;
+    float wowDepth = 0.2f;
+    float flutterRate = 2.7f;
+    float flutterDepth = 0.1f;
+    int wowWaveform = 0;
+    int flutterWaveform = 0;
+    float saturation = 0.3f;
+    float bumpFreq = 90.0f;
+    float bumpGain = 1.2f;
+    float rolloffFreq = 10000.0f;
+    float rolloffResonance = 0.7f;
+    float aging = 0.0f;
+    float instability = 0.0f;
+    int headConfig = 0;
+    bool noiseEnabled = false;
+    float noiseAmount = 0.1f;
+};
+
 /**
  * @brief Main CurveAndDrag module class
  * 
  * A stereo delay and pitch shifter with microtonal support via MTS-ESP.
  * Features tape-style delay effects, cross-feedback, and comprehensive
- * CV control over all parameters.
+ * CV control over all parameters. Polyphonic: up to 16 voices per cable,
+ * processed in groups of four SIMD lanes.
  */
 class CurveAndDragModule : public Module {
 public:
@@ -172,7 +239,24 @@ public:
         PITCH_BBD = 0,          // Bucket Brigade style
         PITCH_H910,             // Harmonizer style
         PITCH_VARISPEED,        // Tape varispeed style
-        PITCH_HYBRID            // Hybrid algorithm
+        PITCH_HYBRID,           // Hybrid algorithm
+        PITCH_SPECTRAL          // Phase vocoder
+    };
+
+    /**
+     * @brief Spectral mode harmony presets: intervals added to each voice
+     */
+    enum HarmonyPreset {
+        HARMONY_OFF = 0,
+        HARMONY_OCTAVE,         // +12
+        HARMONY_FIFTH,          // +7
+        HARMONY_POWER,          // +7, +12
+        HARMONY_MAJOR,          // +4, +7
+        HARMONY_MINOR,          // +3, +7
+        HARMONY_MAJOR_7,        // +4, +7, +11
+        HARMONY_MINOR_7,        // +3, +7, +10
+        HARMONY_OCTAVES,        // -12, +12
+        NUM_HARMONY_PRESETS
     };
 
     /**
@@ -195,7 +279,7 @@ public:
     /**
      * @brief Destructor - ensures proper cleanup
      */
-    ~CurveAndDragModule() = default;
+    ~CurveAndDragModule();
 
     /**
      * @brief Reset module to initial state
@@ -246,6 +330,226 @@ public:
      */
     std::string getSubdivisionName(SubdivisionType subdivision);
 
+    /**
+     * @brief Set the number of frames collected before the DSP stages run
+     * 
+     * Applied on the next block boundary. Adds the same number of frames
+     * of latency to all outputs.
+     * 
+     * @param size Block size in frames (16-256)
+     */
+    void setBlockSize(int size) {
+        requestedBlockSize = clamp(size, MIN_BLOCK_SIZE, MAX_BLOCK_SIZE);
+    }
+
+    /**
+     * @brief Get the requested block size in frames
+     */
+    int getBlockSize() const {
+        return requestedBlockSize;
+    }
+
+    /**
+     * @brief Select the delay line read interpolation
+     * 
+     * Applied on the next block boundary.
+     * 
+     * @param quality One of InterpolationQuality
+     */
+    void setDelayInterpolation(int quality) {
+        requestedInterpolation = clamp(quality, 0, NUM_INTERP_QUALITIES - 1);
+    }
+
+    /**
+     * @brief Get the requested delay line read interpolation
+     */
+    int getDelayInterpolation() const {
+        return requestedInterpolation;
+    }
+
+    /**
+     * @brief Oversample the nonlinear stages
+     * 
+     * Covers the post-pitch character stage and the tape saturation and
+     * output limiter; delay lines and tape heads stay at the host rate.
+     * Applied on the next block boundary.
+     * 
+     * @param factor 1 (off), 2, 4 or 8
+     */
+    void setOversampling(int factor) {
+        requestedOversampling = (factor >= 8) ? 8 : (factor >= 4) ? 4 : (factor >= 2) ? 2 : 1;
+    }
+
+    /**
+     * @brief Get the requested oversampling factor
+     */
+    int getOversampling() const {
+        return requestedOversampling;
+    }
+
+    /**
+     * @brief Latency each oversampled stage adds, in samples
+     * 
+     * The wet path runs through up to three such stages in series: the
+     * character stage while pitch shifting, and the tape saturation and
+     * limiter while tape mode is on.
+     */
+    float getOversamplingLatencySamples() const {
+        return TOversampler<float_4>::latencySamples(requestedOversampling);
+    }
+
+    /**
+     * @brief Run Spectral mode FFT work on a background worker thread
+     * 
+     * Removes the per-hop CPU spike from the engine thread and adds one
+     * vocoder hop of latency to Spectral mode.
+     * 
+     * @param enabled true to use the worker thread
+     */
+    void setSpectralWorker(bool enabled) {
+        spectralWorker = enabled;
+    }
+
+    /**
+     * @brief Lock Spectral mode bins to the phase of their spectral peak
+     * 
+     * Keeps partials coherent, so 2x overlap sounds about as clean as 4x
+     * at half the FFT work.
+     * 
+     * @param enabled true for phase-locked synthesis
+     */
+    void setSpectralPhaseLocking(bool enabled) {
+        spectralPhaseLocking = enabled;
+    }
+
+    /**
+     * @brief Get whether Spectral mode uses phase-locked synthesis
+     */
+    bool getSpectralPhaseLocking() const {
+        return spectralPhaseLocking;
+    }
+
+    /**
+     * @brief Select the Spectral mode harmony preset
+     * 
+     * Harmony voices are synthesized from each vocoder's own analysis, so
+     * they cost far less than extra vocoders. Their intervals follow the
+     * left/right detune and, with Quantize on, snap to the active scale.
+     * 
+     * @param preset One of HarmonyPreset
+     */
+    void setSpectralHarmony(int preset) {
+        spectralHarmony = clamp(preset, 0, NUM_HARMONY_PRESETS - 1);
+    }
+
+    /**
+     * @brief Get the Spectral mode harmony preset
+     */
+    int getSpectralHarmony() const {
+        return spectralHarmony;
+    }
+
+    /**
+     * @brief Get the intervals of a harmony preset
+     * 
+     * @param preset One of HarmonyPreset
+     * @param cents Receives up to PitchShifter::MAX_HARMONY_VOICES intervals
+     * @return Number of harmony voices
+     */
+    static int getHarmonyIntervals(int preset, float* cents) {
+        switch (preset) {
+            case HARMONY_OCTAVE: cents[0] = 1200.0f; return 1;
+            case HARMONY_FIFTH: cents[0] = 700.0f; return 1;
+            case HARMONY_POWER: cents[0] = 700.0f; cents[1] = 1200.0f; return 2;
+            case HARMONY_MAJOR: cents[0] = 400.0f; cents[1] = 700.0f; return 2;
+            case HARMONY_MINOR: cents[0] = 300.0f; cents[1] = 700.0f; return 2;
+            case HARMONY_MAJOR_7: cents[0] = 400.0f; cents[1] = 700.0f; cents[2] = 1100.0f; return 3;
+            case HARMONY_MINOR_7: cents[0] = 300.0f; cents[1] = 700.0f; cents[2] = 1000.0f; return 3;
+            case HARMONY_OCTAVES: cents[0] = -1200.0f; cents[1] = 1200.0f; return 2;
+            default: return 0;
+        }
+    }
+
+    /**
+     * @brief Get harmony preset display name
+     */
+    static std::string getHarmonyPresetName(int preset) {
+        switch (preset) {
+            case HARMONY_OCTAVE: return "Octave";
+            case HARMONY_FIFTH: return "Fifth";
+            case HARMONY_POWER: return "Power (5th + Octave)";
+            case HARMONY_MAJOR: return "Major Triad";
+            case HARMONY_MINOR: return "Minor Triad";
+            case HARMONY_MAJOR_7: return "Major 7th";
+            case HARMONY_MINOR_7: return "Minor 7th";
+            case HARMONY_OCTAVES: return "Octave Below + Above";
+            default: return "Off";
+        }
+    }
+
+    /**
+     * @brief Get whether Spectral mode uses the worker thread
+     */
+    bool getSpectralWorker() const {
+        return spectralWorker;
+    }
+
+    /**
+     * @brief Set the Spectral mode FFT frame size
+     * 
+     * Larger frames resolve low notes better at the cost of latency.
+     * 
+     * @param size Frame size in samples, a power of two (256-8192)
+     */
+    void setSpectralFftSize(int size) {
+        int powerOfTwo = PitchShifter::MIN_FFT_SIZE;
+        while (powerOfTwo * 2 <= size && powerOfTwo < PitchShifter::MAX_FFT_SIZE) {
+            powerOfTwo *= 2;
+        }
+        spectralFftSize = powerOfTwo;
+    }
+
+    /**
+     * @brief Get the Spectral mode FFT frame size in samples
+     */
+    int getSpectralFftSize() const {
+        return spectralFftSize;
+    }
+
+    /**
+     * @brief Set the Spectral mode overlap factor
+     * 
+     * More overlap smooths transients and costs proportionally more CPU.
+     * 
+     * @param overlap Frames overlapping each sample (2, 4 or 8)
+     */
+    void setSpectralOverlap(int overlap) {
+        spectralOverlap = (overlap >= 8) ? 8 : (overlap >= 4) ? 4 : 2;
+    }
+
+    /**
+     * @brief Get the Spectral mode overlap factor
+     */
+    int getSpectralOverlap() const {
+        return spectralOverlap;
+    }
+
+    /**
+     * @brief Spectral mode latency in samples for the current settings
+     */
+    int getSpectralLatencySamples() const {
+        int fftSize = spectralFftSize;
+        return PitchShifter::latencySamples(fftSize, fftSize / spectralOverlap, spectralWorker);
+    }
+
+    static constexpr int MIN_BLOCK_SIZE = 16;
+    static constexpr int MAX_BLOCK_SIZE = 256;
+    static constexpr int DEFAULT_BLOCK_SIZE = 32;
+    static constexpr int DEFAULT_OVERSAMPLING = 2;
+    static constexpr int MAX_GROUPS = PORT_MAX_CHANNELS / 4; // float_4 voice groups
+    static constexpr int DEFAULT_SPECTRAL_FFT_SIZE = 2048;
+    static constexpr int DEFAULT_SPECTRAL_OVERLAP = 4;
+
     // ===== NEW MEMBER VARIABLES FOR ENHANCED FUNCTIONALITY =====
     float lastDetuneL = 0.0f;   // Stored left detune for independent processing  
     float lastDetuneR = 0.0f;   // Stored right detune for independent processing
@@ -254,13 +558,51 @@ public:
     int currentScaleIndex = 0;
 
 private:
-    // Audio processing components
-    DelayLine leftDelay;
-    DelayLine rightDelay;
-    PitchShifter pitchShifter;
-    TapeDelayProcessor tapeProcessor;
+    // Audio processing components, one per group of 4 poly voices
+    std::array<TDelayLine<float_4>, MAX_GROUPS> leftDelay;
+    std::array<TDelayLine<float_4>, MAX_GROUPS> rightDelay;
+    std::array<TTapeDelayProcessor<float_4>, MAX_GROUPS> tapeProcessor;
+    std::array<PitchEngineGroup, MAX_GROUPS> pitchEngines;
+    std::array<TOversampler<float_4>, MAX_GROUPS> characterOversamplerL;
+    std::array<TOversampler<float_4>, MAX_GROUPS> characterOversamplerR;
+    std::array<CrossFeedbackState, MAX_GROUPS> crossFeedback;
+    PitchSmoothingState pitchSmoothing;
     MTSESPClient mtsClient;
 
+    // Delay, tape and pitch engine buffers are built on the shared allocator thread
+    struct BufferClient : AllocationClient {
+        CurveAndDragModule* module = nullptr;
+        void allocate() override {
+            module->allocateBuffers();
+        }
+        void collect() override {
+            module->collectBuffers();
+        }
+    };
+    BufferClient bufferClient;
+    std::atomic<float> allocSampleRate{44100.0f};
+    std::atomic<int> allocGroups{1};        // Voice groups that need delay buffers
+    std::atomic<bool> allocTape{false};     // Tape loops needed (tape mode used)
+    std::atomic<int> allocPitchModes{0};    // Time-domain pitch modes used (bit per mode)
+    std::atomic<int> allocSpectralVoices{0}; // Voices Spectral mode has asked for
+
+    // Spectral mode vocoders, one per poly voice, built on the allocator
+    // thread; only the first spectralVoicesReady entries are published
+    std::array<std::unique_ptr<SpectralVoice>, PORT_MAX_CHANNELS> spectralVoices;
+    std::atomic<int> spectralVoicesReady{0};
+    std::atomic<bool> spectralWorker{false};  // Vocoder frames run on the SpectralWorker
+    std::atomic<int> spectralFftSize{DEFAULT_SPECTRAL_FFT_SIZE};
+    std::atomic<int> spectralOverlap{DEFAULT_SPECTRAL_OVERLAP};
+    std::atomic<int> spectralHarmony{HARMONY_OFF};
+    std::atomic<bool> spectralPhaseLocking{false};
+    // Vocoder settings as last applied on a block boundary, and the voices
+    // they have been applied to
+    float spectralSampleRate = 0.0f;
+    int spectralAppliedFftSize = 0;
+    int spectralAppliedOverlap = 0;
+    bool spectralAppliedWorker = false;
+    int spectralVoicesConfigured = 0;
+
     // Timing and trigger components
     dsp::SchmittTrigger leftTapTrigger;
     dsp::SchmittTrigger rightTapTrigger;
@@ -272,11 +614,21 @@ private:
     float rightLevelSmooth = 0.0f;
     static constexpr float LEVEL_SMOOTH_RATE = 0.01f;
 
-    // CV modulation storage
-    float pitchCVModulation = 0.0f;
-    float outputGainModulation = 0.0f;
-    float timeCVGlobal = 0.0f;
-    float feedbackCVGlobal = 0.0f;
+    // Control-rate parameter state
+    static constexpr int CONTROL_RATE = 32; // Read params/CV at most every N samples
+    ParameterSnapshot snapshot;
+    int controlFrames = CONTROL_RATE;       // Forces a read on the first block
+
+    // Per-sample ramps toward the latest snapshot
+    LinearRamp inputGainRamp;
+    LinearRamp outputGainRamp;
+    LinearRamp outputMixRampL;
+    LinearRamp outputMixRampR;
+    LinearRamp crossAmountRamp;
+    std::array<TLinearRamp<float_4>, MAX_GROUPS> pitchRatioRampL;
+    std::array<TLinearRamp<float_4>, MAX_GROUPS> pitchRatioRampR;
+    std::array<TLinearRamp<float_4>, MAX_GROUPS> gainCompRampL;
+    std::array<TLinearRamp<float_4>, MAX_GROUPS> gainCompRampR;
 
     // Process rate limiting
     int processCounter = 0;
@@ -287,13 +639,59 @@ private:
     // Tempo detection
     float detectedBPM = 120.0f;
     float lastTapTime = 0.0f;
+    float lastLeftSubdiv = -1.0f;
+    float lastRightSubdiv = -1.0f;
+
+    // Block processing: frames are collected here and the DSP stages run
+    // once per block; outputs are emitted one block later
+    using BlockBuffer = std::array<float_4, MAX_BLOCK_SIZE>;
+    std::atomic<int> requestedBlockSize{DEFAULT_BLOCK_SIZE};
+    int blockSize = DEFAULT_BLOCK_SIZE;
+    std::atomic<int> requestedInterpolation{INTERP_LINEAR};
+    int interpolation = INTERP_LINEAR;
+    std::atomic<int> requestedOversampling{DEFAULT_OVERSAMPLING};
+    int oversampling = 1;
+    int blockPos = 0;
+    int channels = 1;           // Poly channels in the block being collected
+    int outputChannels = 1;     // Poly channels in the block being emitted
+    float blockInputGain = 1.0f;
+    std::array<BlockBuffer, MAX_GROUPS> blockInputL = {};
+    std::array<BlockBuffer, MAX_GROUPS> blockInputR = {};
+    BlockBuffer blockProcessL = {};     // Scratch, reused by each group
+    BlockBuffer blockProcessR = {};
+    std::array<BlockBuffer, MAX_GROUPS> blockOutputL = {};
+    std::array<BlockBuffer, MAX_GROUPS> blockOutputR = {};
+    std::array<BlockBuffer, MAX_GROUPS> blockWetL = {};
+    std::array<BlockBuffer, MAX_GROUPS> blockWetR = {};
 
     // ===== PRIVATE METHODS =====
 
     /**
-     * @brief Process all 21 CV inputs for complete automation
+     * @brief Run every DSP stage over a collected block of frames
+     * 
+     * @param n Number of frames in the block
+     */
+    void processAudioBlock(int n);
+
+    /**
+     * @brief Run the signal chain for one group of 4 poly voices
+     * 
+     * @param g Group index (voices 4g to 4g+3)
+     * @param n Number of frames in the block
+     */
+    void processVoiceGroup(int g, int n);
+
+    /**
+     * @brief Read all parameters and CV inputs into the control snapshot
+     */
+    void updateParameterSnapshot();
+
+    /**
+     * @brief Push the control snapshot to the DSP components
+     * 
+     * @param frames Number of frames since the previous control update
      */
-    void processAllCVInputs();
+    void applyParameterSnapshot(int frames);
 
     /**
      * @brief Update parameter displays with proper subdivision names
@@ -307,13 +705,29 @@ private:
 
     /**
      * @brief Process tape mode with full stereo functionality
+     * @param frames Samples until the next parameter update, used for EQ coefficient ramps
+     */
+    void processTapeMode(int frames);
+
+    /**
+     * @brief Spectral pitch mode: run each voice through its L/R vocoders
+     */
+    void processSpectralPitch(int g, int n, float_4 leftCents, float_4 rightCents);
+
+    /**
+     * @brief Build the buffers the audio thread asked for (allocator thread)
+     */
+    void allocateBuffers();
+
+    /**
+     * @brief Free buffers the audio thread has replaced (allocator thread)
      */
-    void processTapeMode();
+    void collectBuffers();
 
     /**
      * @brief Process delay parameters with CV modulation
      */
-    void processDelayParameters(float sampleRate);
+    void processDelayParameters();
 
     /**
      * @brief Process tap tempo detection and application
@@ -322,8 +736,11 @@ private:
 
     /**
      * @brief Process pitch shifting parameters with CV
+     * 
+     * @param frames Number of frames since the previous call, used to scale
+     *               the per-sample smoothing rates
      */
-    void processPitchParameters();
+    void processPitchParameters(int frames);
 
     /**
      * @brief Process tape delay parameters with CV
@@ -358,9 +775,21 @@ private:
      * @param minVal Minimum parameter value
      * @param maxVal Maximum parameter value
      * @param defaultVal Default value if CV not connected
+     * @param channel Poly channel of the CV input (mono CV applies to all)
      * @return Clamped parameter value with CV modulation
      */
-    float getClampedParam(int paramId, int cvInputId, float minVal, float maxVal, float defaultVal = 0.0f);
+    float getClampedParam(int paramId, int cvInputId, float minVal, float maxVal, float defaultVal = 0.0f, int channel = 0);
+
+    /**
+     * @brief Quantize pitch with the active tuning source
+     * 
+     * Uses MTS-ESP when enabled and connected, otherwise the built-in
+     * scale selected in the snapshot.
+     * 
+     * @param pitchCents Raw pitch in cents
+     * @return Quantized pitch in cents
+     */
+    float quantizePitch(float pitchCents);
 
     /**
      * @brief Quantize pitch using MTS-ESP
@@ -391,7 +820,7 @@ private:
      * @brief Apply soft clipping to prevent harsh distortion
      */
     inline float softClip(float input) {
-        return std::tanh(input * 0.7f);
+        return fastTanh(input * 0.7f);
     }
 
     /**
@@ -432,6 +861,7 @@ private:
             case PITCH_H910: return "H910";
             case PITCH_VARISPEED: return "Varispeed";
             case PITCH_HYBRID: return "Hybrid";
+            case PITCH_SPECTRAL: return "Spectral";
             default: return "BBD";
         }
     }
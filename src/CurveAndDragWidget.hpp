@@ -464,7 +464,7 @@ struct CurveAndDragWidget : ModuleWidget {
         menu->addChild(createMenuLabel("• Tape Noise: 0-8% (Fixed)"));
         menu->addChild(createMenuLabel("• Head Config: 1-4 Heads"));
         menu->addChild(createMenuLabel("• Scale Select: 0-10 Built-in"));
-        menu->addChild(createMenuLabel("• Pitch Algorithms: BBD/H910/Tape/Hybrid"));
+        menu->addChild(createMenuLabel("• Pitch Algorithms: BBD/H910/Tape/Hybrid/Spectral"));
         
         // Scale loading options
         menu->addChild(new MenuSeparator);
@@ -482,8 +482,8 @@ struct CurveAndDragWidget : ModuleWidget {
         menu->addChild(createMenuLabel("Pitch Algorithms"));
         
         menu->addChild(createSubmenuItem("Algorithm Selection", "", [=](Menu* subMenu) {
-            std::vector<std::string> modeNames = {"BBD (Analog)", "H910 (Harmonizer)", "Varispeed (Tape)", "Hybrid"};
-            for (int i = 0; i < 4; i++) {
+            std::vector<std::string> modeNames = {"BBD (Analog)", "H910 (Harmonizer)", "Varispeed (Tape)", "Hybrid", "Spectral (Phase Vocoder)"};
+            for (int i = 0; i < (int)modeNames.size(); i++) {
                 subMenu->addChild(createMenuItem(modeNames[i], 
                     module->params[CurveAndDragModule::PITCH_MODE_PARAM].getValue() == i ? "✓" : "", 
                     [=]() {
@@ -496,6 +496,91 @@ struct CurveAndDragWidget : ModuleWidget {
         menu->addChild(new MenuSeparator);
         menu->addChild(createMenuLabel("Performance"));
         
+        menu->addChild(createSubmenuItem("Block Size", std::to_string(module->getBlockSize()), [=](Menu* subMenu) {
+            for (int size = CurveAndDragModule::MIN_BLOCK_SIZE; size <= CurveAndDragModule::MAX_BLOCK_SIZE; size *= 2) {
+                subMenu->addChild(createMenuItem(std::to_string(size) + " frames",
+                    module->getBlockSize() == size ? "✓" : "",
+                    [=]() {
+                        module->setBlockSize(size);
+                    }));
+            }
+        }));
+        
+        menu->addChild(createSubmenuItem("Delay Interpolation", "", [=](Menu* subMenu) {
+            std::vector<std::string> qualityNames = {"None", "Linear", "Cubic Hermite", "Lagrange 4-point",
+                                                     "Lagrange 6-point", "Thiran Allpass", "Windowed Sinc"};
+            for (int i = 0; i < NUM_INTERP_QUALITIES; i++) {
+                subMenu->addChild(createMenuItem(qualityNames[i],
+                    module->getDelayInterpolation() == i ? "✓" : "",
+                    [=]() {
+                        module->setDelayInterpolation(i);
+                    }));
+            }
+        }));
+
+        std::string oversamplingName = (module->getOversampling() > 1) ? std::to_string(module->getOversampling()) + "x" : "Off";
+        menu->addChild(createSubmenuItem("Nonlinear Oversampling", oversamplingName, [=](Menu* subMenu) {
+            for (int factor = 1; factor <= TOversampler<float_4>::MAX_FACTOR; factor *= 2) {
+                subMenu->addChild(createMenuItem((factor > 1) ? std::to_string(factor) + "x" : "Off",
+                    module->getOversampling() == factor ? "✓" : "",
+                    [=]() {
+                        module->setOversampling(factor);
+                    }));
+            }
+        }));
+
+        float oversamplingLatency = module->getOversamplingLatencySamples();
+        float oversamplingLatencyMs = 1000.0f * oversamplingLatency / APP->engine->getSampleRate();
+        menu->addChild(createMenuLabel(string::f("  Oversampling latency: %.2f samples (%.2f ms) per stage",
+                                                 oversamplingLatency, oversamplingLatencyMs)));
+
+        menu->addChild(createSubmenuItem("Spectral FFT Size", std::to_string(module->getSpectralFftSize()), [=](Menu* subMenu) {
+            for (int size = PitchShifter::MIN_FFT_SIZE; size <= PitchShifter::MAX_FFT_SIZE; size *= 2) {
+                subMenu->addChild(createMenuItem(std::to_string(size) + " samples",
+                    module->getSpectralFftSize() == size ? "✓" : "",
+                    [=]() {
+                        module->setSpectralFftSize(size);
+                    }));
+            }
+        }));
+
+        menu->addChild(createSubmenuItem("Spectral Overlap", std::to_string(module->getSpectralOverlap()) + "x", [=](Menu* subMenu) {
+            for (int overlap = PitchShifter::MIN_OVERLAP; overlap <= PitchShifter::MAX_OVERLAP; overlap *= 2) {
+                subMenu->addChild(createMenuItem(std::to_string(overlap) + "x",
+                    module->getSpectralOverlap() == overlap ? "✓" : "",
+                    [=]() {
+                        module->setSpectralOverlap(overlap);
+                    }));
+            }
+        }));
+
+        menu->addChild(createSubmenuItem("Spectral Harmony", CurveAndDragModule::getHarmonyPresetName(module->getSpectralHarmony()), [=](Menu* subMenu) {
+            for (int i = 0; i < CurveAndDragModule::NUM_HARMONY_PRESETS; i++) {
+                subMenu->addChild(createMenuItem(CurveAndDragModule::getHarmonyPresetName(i),
+                    module->getSpectralHarmony() == i ? "✓" : "",
+                    [=]() {
+                        module->setSpectralHarmony(i);
+                    }));
+            }
+        }));
+
+        menu->addChild(createMenuItem("Spectral Phase Locking",
+            module->getSpectralPhaseLocking() ? "✓" : "",
+            [=]() {
+                module->setSpectralPhaseLocking(!module->getSpectralPhaseLocking());
+            }));
+
+        menu->addChild(createMenuItem("Spectral Worker Thread",
+            module->getSpectralWorker() ? "✓" : "",
+            [=]() {
+                module->setSpectralWorker(!module->getSpectralWorker());
+            }));
+
+        int spectralLatency = module->getSpectralLatencySamples();
+        float spectralLatencyMs = 1000.0f * spectralLatency / APP->engine->getSampleRate();
+        menu->addChild(createMenuLabel(string::f("  Spectral latency: %d samples (%.1f ms)",
+                                                 spectralLatency, spectralLatencyMs)));
+
         menu->addChild(createMenuItem("Reset All Parameters", "", [=]() {
             module->onReset();
         }));
@@ -1,26 +1,48 @@
 #pragma once
 #include <rack.hpp>
+#include <algorithm>
 #include <vector>
 #include <cmath>
+#include <tuple>
+#include "LinearRamp.hpp"
+#include "SimdUtils.hpp"
+#include "RingBuffer.hpp"
+#include "Interpolation.hpp"
 
 namespace CurveAndDrag {
 
 /**
- * DelayLine - Class for implementing a delay line with interpolation
+ * TDelayLine - Class for implementing a delay line with interpolation
  * 
- * Features smooth delay time changes, feedback, and cross-feedback options
+ * Features smooth delay time changes, feedback, and cross-feedback options.
+ * T is float, or float_4 to run four poly voices per SIMD lane, each with
+ * its own delay time, feedback and dry/wet.
+ *
+ * Reads use one of the interpolation policies in Interpolation.hpp. Each
+ * policy gets its own instantiation of the block loop, picked once per
+ * block, so the per-sample read is fully inlined.
+ *
+ * The buffer is not allocated by the delay line itself: prepareBuffer()
+ * builds it on a background thread and the block loop picks it up at the
+ * next block, fading the delayed signal out and back in around the swap.
+ * Until then the delay line passes only the dry signal.
  */
-class DelayLine {
+template <typename T>
+class TDelayLine {
 public:
-    DelayLine() {
+    TDelayLine() {
         // Initialize with default values
         sampleRate = 44100.0f;
         maxDelayTimeMs = 2000.0f;  // 2 seconds maximum delay
         delayTimeMs = 100.0f;      // Default 100ms
         feedback = 0.5f;           // Default 50% feedback
         dryWet = 0.5f;             // Default 50/50 dry/wet
+        interpolation = INTERP_LINEAR;
         
-        // Initialize buffers
+        // Build the shared sinc table here rather than on the audio thread
+        SincTable::get();
+        
+        // Initialize state; the buffer arrives later from prepareBuffer()
         reset();
     }
 
@@ -28,13 +50,18 @@ public:
      * Reset all internal buffer state
      */
     void reset() {
-        // Calculate buffer size based on max delay time
-        int bufferSize = static_cast<int>(std::ceil((maxDelayTimeMs / 1000.0f) * sampleRate)) + 2;
-        buffer.resize(bufferSize, 0.0f);
+        // Clear the buffer in place; reallocation only happens off-thread
+        buffer.clear();
         writeIndex = 0;
         
         // Calculate read position based on current delay time
         delayInSamples = (delayTimeMs / 1000.0f) * sampleRate;
+        
+        // Start the block ramps at the current settings
+        delayRamp.reset(delayInSamples);
+        feedbackRamp.reset(feedback);
+        dryWetRamp.reset(dryWet);
+        resetInterpolators();
     }
 
     /**
@@ -45,8 +72,41 @@ public:
     void configure(float newSampleRate) {
         if (sampleRate != newSampleRate) {
             sampleRate = newSampleRate;
-            reset();
+            delayInSamples = (delayTimeMs / 1000.0f) * sampleRate;
+            delayRamp.reset(delayInSamples);
+        }
+    }
+
+    /**
+     * Build a buffer long enough for the maximum delay at a sample rate
+     * 
+     * Call from a background thread, never the audio thread. Does nothing
+     * if a buffer for this sample rate was already prepared.
+     * 
+     * @param forSampleRate Sample rate the buffer must cover
+     */
+    void prepareBuffer(float forSampleRate) {
+        if (forSampleRate == preparedSampleRate) {
+            buffer.collect();
+            return;
         }
+        int bufferSize = static_cast<int>(std::ceil((maxDelayTimeMs / 1000.0f) * forSampleRate)) + 2;
+        buffer.prepare(bufferSize);
+        preparedSampleRate = forSampleRate;
+    }
+
+    /**
+     * Free a buffer replaced on the audio thread (background thread only)
+     */
+    void collectBuffer() {
+        buffer.collect();
+    }
+
+    /**
+     * @return true if a replaced buffer is waiting for collectBuffer()
+     */
+    bool hasRetiredBuffer() const {
+        return buffer.hasRetired();
     }
 
     /**
@@ -54,9 +114,9 @@ public:
      * 
      * @param newDelayTimeMs Delay time in milliseconds (1-2000 ms)
      */
-    void setDelayTime(float newDelayTimeMs) {
+    void setDelayTime(T newDelayTimeMs) {
         // Constrain to valid range
-        delayTimeMs = rack::math::clamp(newDelayTimeMs, 1.0f, maxDelayTimeMs);
+        delayTimeMs = simd::clamp(newDelayTimeMs, T(1.0f), T(maxDelayTimeMs));
         delayInSamples = (delayTimeMs / 1000.0f) * sampleRate;
     }
 
@@ -65,9 +125,9 @@ public:
      * 
      * @param newFeedback Feedback amount (0.0-1.1)
      */
-    void setFeedback(float newFeedback) {
+    void setFeedback(T newFeedback) {
         // Allow feedback up to 110%, but don't exceed that to prevent runaway
-        feedback = rack::math::clamp(newFeedback, 0.0f, 1.1f);
+        feedback = simd::clamp(newFeedback, T(0.0f), T(1.1f));
     }
 
     /**
@@ -75,8 +135,30 @@ public:
      * 
      * @param newDryWet Dry/wet mix amount (0.0-1.0)
      */
-    void setDryWet(float newDryWet) {
-        dryWet = rack::math::clamp(newDryWet, 0.0f, 1.0f);
+    void setDryWet(T newDryWet) {
+        dryWet = simd::clamp(newDryWet, T(0.0f), T(1.0f));
+    }
+
+    /**
+     * Select the read interpolation
+     * 
+     * @param quality One of InterpolationQuality
+     */
+    void setInterpolation(int quality) {
+        if (quality < 0 || quality >= NUM_INTERP_QUALITIES) {
+            quality = INTERP_LINEAR;
+        }
+        if (quality != interpolation) {
+            interpolation = quality;
+            resetInterpolators();
+        }
+    }
+
+    /**
+     * Get the read interpolation
+     */
+    int getInterpolation() const {
+        return interpolation;
     }
 
     /**
@@ -86,12 +168,19 @@ public:
      * @param externalFeedback Optional external feedback signal (for cross-feedback)
      * @return Processed output sample
      */
-    float process(float input, float externalFeedback = 0.0f) {
+    T process(T input, T externalFeedback = 0.0f) {
+        updateBuffer(1);
+        
+        // The per-sample path uses settings directly; keep block ramps in step
+        delayRamp.reset(delayInSamples);
+        feedbackRamp.reset(feedback);
+        dryWetRamp.reset(dryWet);
+        
         // Read from delay line with linear interpolation
-        float delayedSample = read();
+        T delayedSample = read();
         
         // Apply feedback with optional external signal
-        float feedbackSignal = feedback * delayedSample + externalFeedback;
+        T feedbackSignal = feedback * delayedSample + externalFeedback;
         
         // Write to delay line
         write(input + feedbackSignal);
@@ -100,12 +189,37 @@ public:
         return input * (1.0f - dryWet) + delayedSample * dryWet;
     }
 
+    /**
+     * Process a block of audio samples through the delay line
+     * 
+     * Keeps the write index in a local so the loop runs without reloading
+     * state; positions wrap by mask and reads rely on the buffer's guard.
+     * Delay time, feedback and dry/wet ramp linearly from their values at
+     * the end of the previous block to the current settings.
+     * 
+     * @param in Input samples
+     * @param out Output samples (may alias the input)
+     * @param n Number of samples in the block
+     */
+    void processBlock(const T* in, T* out, int n) {
+        updateBuffer(n);
+        switch (interpolation) {
+            case INTERP_NONE: processBlockWith(std::get<INTERP_NONE>(interpolators), in, out, n); break;
+            case INTERP_LINEAR: processBlockWith(std::get<INTERP_LINEAR>(interpolators), in, out, n); break;
+            case INTERP_HERMITE: processBlockWith(std::get<INTERP_HERMITE>(interpolators), in, out, n); break;
+            case INTERP_LAGRANGE4: processBlockWith(std::get<INTERP_LAGRANGE4>(interpolators), in, out, n); break;
+            case INTERP_LAGRANGE6: processBlockWith(std::get<INTERP_LAGRANGE6>(interpolators), in, out, n); break;
+            case INTERP_THIRAN: processBlockWith(std::get<INTERP_THIRAN>(interpolators), in, out, n); break;
+            case INTERP_SINC: processBlockWith(std::get<INTERP_SINC>(interpolators), in, out, n); break;
+        }
+    }
+
     /**
      * Get the delayed signal only (no dry/wet mixing)
      * 
      * @return The current delayed output sample
      */
-    float getDelayedSignal() {
+    T getDelayedSignal() {
         return read();
     }
 
@@ -114,44 +228,157 @@ public:
      * 
      * @return The current wet output sample
      */
-    float getWetSignal() {
+    T getWetSignal() {
         return read(); // Return pure delayed signal without dry/wet mixing
     }
 
 private:
     float sampleRate;
     float maxDelayTimeMs;
-    float delayTimeMs;
-    float delayInSamples;
-    float feedback;
-    float dryWet;
+    T delayTimeMs;
+    T delayInSamples;
+    T feedback;
+    T dryWet;
     
-    std::vector<float> buffer;
+    TRingBuffer<T, MAX_INTERP_TAPS> buffer;
     int writeIndex;
+    float preparedSampleRate = 0.0f;   // Background thread only
+    
+    // Fade of the delayed signal around a buffer swap
+    static constexpr int FADE_SAMPLES = 256;
+    TLinearRamp<float> bufferFade;
+    
+    // Smoothed settings used by processBlock()
+    TLinearRamp<T> delayRamp;
+    TLinearRamp<T> feedbackRamp;
+    TLinearRamp<T> dryWetRamp;
+    
+    // Read interpolation, indexed by InterpolationQuality
+    int interpolation;
+    std::tuple<NoInterpolation<T>, LinearInterpolation<T>, HermiteInterpolation<T>,
+               Lagrange4Interpolation<T>, Lagrange6Interpolation<T>,
+               ThiranInterpolation<T>, SincInterpolation<T>> interpolators;
 
     /**
-     * Read from the delay line with linear interpolation
+     * Publish a prepared buffer at a block boundary
      * 
-     * @return Interpolated sample from delay line
+     * A buffer that is playing is faded out first; the new one fades in.
+     * 
+     * @param n Number of samples in the coming block
      */
-    float read() {
-        // Calculate read position
-        float readPos = writeIndex - delayInSamples;
-        if (readPos < 0) {
-            readPos += buffer.size();
+    void updateBuffer(int n) {
+        float target = 1.0f;
+        if (buffer.hasPending()) {
+            target = 0.0f;
+            if ((buffer.empty() || bufferFade.value <= 0.0f) && buffer.publish()) {
+                writeIndex = 0;
+                resetInterpolators();
+                target = 1.0f;
+            }
+        }
+        float maxStep = static_cast<float>(n) / FADE_SAMPLES;
+        float step = std::max(-maxStep, std::min(target - bufferFade.value, maxStep));
+        bufferFade.setTarget(bufferFade.value + step, n);
+    }
+
+    /**
+     * Clear the state of the stateful interpolators
+     */
+    void resetInterpolators() {
+        std::get<INTERP_THIRAN>(interpolators).reset();
+    }
+
+    /**
+     * Process a block with one interpolation policy
+     * 
+     * @param interp Interpolator state, updated at the end of the block
+     * @param in Input samples
+     * @param out Output samples (may alias the input)
+     * @param n Number of samples in the block
+     */
+    template <class Interp>
+    void processBlockWith(Interp& interp, const T* in, T* out, int n) {
+        const T* buf = buffer.data();
+        const float size = static_cast<float>(buffer.capacity());
+        const int mask = buffer.getMask();
+        int w = writeIndex;
+        
+        delayRamp.setTarget(delayInSamples, n);
+        feedbackRamp.setTarget(feedback, n);
+        dryWetRamp.setTarget(dryWet, n);
+        TLinearRamp<T> delay = delayRamp;
+        TLinearRamp<T> fb = feedbackRamp;
+        TLinearRamp<T> wet = dryWetRamp;
+        TLinearRamp<float> fade = bufferFade;
+        Interp reader = interp;
+        
+        // No buffer yet: dry signal only
+        if (buffer.empty()) {
+            for (int i = 0; i < n; i++) {
+                out[i] = in[i] * (1.0f - wet.next());
+            }
+            delayRamp.reset(delayInSamples);
+            feedbackRamp.reset(feedback);
+            dryWetRamp = wet;
+            bufferFade.reset(0.0f);
+            return;
         }
         
-        // Get integer position and fraction for interpolation
-        int readPos_i = static_cast<int>(readPos);
-        float frac = readPos - readPos_i;
+        // A buffer still sized for a lower sample rate limits the delay
+        const T maxDelay = size - (MAX_INTERP_TAPS + 1);
         
-        // Get samples for interpolation
-        int nextPos = (readPos_i + 1) % buffer.size();
-        float sample1 = buffer[readPos_i];
-        float sample2 = buffer[nextPos];
+        for (int i = 0; i < n; i++) {
+            // Interpolated read (per lane for poly voices)
+            T delaySamples = delay.next();
+            delaySamples = simd::ifelse(delaySamples > maxDelay, maxDelay, delaySamples);
+            T readPos = static_cast<float>(w) - delaySamples;
+            readPos = simd::ifelse(readPos < 0.0f, readPos + size, readPos);
+            T delayedSample = reader.read(buf, readPos, mask) * fade.next();
+            
+            // Write input plus feedback
+            T input = in[i];
+            buffer.write(w, input + fb.next() * delayedSample);
+            w = (w + 1) & mask;
+            
+            T mix = wet.next();
+            out[i] = input * (1.0f - mix) + delayedSample * mix;
+        }
         
-        // Linear interpolation
-        return sample1 + frac * (sample2 - sample1);
+        writeIndex = w;
+        delayRamp = delay;
+        feedbackRamp = fb;
+        dryWetRamp = wet;
+        bufferFade = fade;
+        interp = reader;
+    }
+
+    /**
+     * Read from the delay line with the selected interpolation
+     * 
+     * @return Interpolated sample from delay line
+     */
+    T read() {
+        if (buffer.empty()) {
+            return T(0.0f);
+        }
+        
+        // Calculate read position
+        const float size = static_cast<float>(buffer.capacity());
+        T readPos = static_cast<float>(writeIndex) - delayInSamples;
+        readPos = simd::ifelse(readPos < 0.0f, readPos + size, readPos);
+        
+        // Interpolate between neighbouring samples
+        const T* buf = buffer.data();
+        const int mask = buffer.getMask();
+        switch (interpolation) {
+            case INTERP_NONE: return std::get<INTERP_NONE>(interpolators).read(buf, readPos, mask);
+            case INTERP_HERMITE: return std::get<INTERP_HERMITE>(interpolators).read(buf, readPos, mask);
+            case INTERP_LAGRANGE4: return std::get<INTERP_LAGRANGE4>(interpolators).read(buf, readPos, mask);
+            case INTERP_LAGRANGE6: return std::get<INTERP_LAGRANGE6>(interpolators).read(buf, readPos, mask);
+            case INTERP_THIRAN: return std::get<INTERP_THIRAN>(interpolators).read(buf, readPos, mask);
+            case INTERP_SINC: return std::get<INTERP_SINC>(interpolators).read(buf, readPos, mask);
+            default: return std::get<INTERP_LINEAR>(interpolators).read(buf, readPos, mask);
+        }
     }
 
     /**
@@ -159,10 +386,15 @@ private:
      * 
      * @param sample Audio sample to write
      */
-    void write(float sample) {
-        buffer[writeIndex] = sample;
-        writeIndex = (writeIndex + 1) % buffer.size();
+    void write(T sample) {
+        if (buffer.empty()) {
+            return;
+        }
+        buffer.write(writeIndex, sample);
+        writeIndex = buffer.wrap(writeIndex + 1);
     }
 };
 
+typedef TDelayLine<float> DelayLine;
+
 } // namespace CurveAndDrag
@@ -0,0 +1,442 @@
+#pragma once
+#include <algorithm>
+#include <cmath>
+#include <utility>
+#include <vector>
+#include "AlignedArena.hpp"
+
+namespace CurveAndDrag {
+
+/**
+ * FFTPlan - Precomputed tables for an in-place power-of-two complex FFT
+ *
+ * configure() builds the twiddle and bit-reversal tables once per size, so
+ * a transform does no trig and no index arithmetic beyond table lookups.
+ * Stages are fused in pairs into radix-4 butterflies (3 complex multiplies
+ * per 4 points), with one radix-2 stage first when log2(n) is odd. Data is
+ * split into separate real and imaginary arrays.
+ *
+ * The forward transform uses the e^(-i) convention; inverse() scales by 1/n.
+ */
+class FFTPlan {
+public:
+    /**
+     * Make room for the tables of transforms up to maxSize (allocates)
+     *
+     * configure() then switches between sizes up to maxSize without
+     * allocating.
+     *
+     * @param maxSize Largest transform size
+     */
+    void reserve(int maxSize) {
+        if (maxSize <= reservedSize) {
+            return;
+        }
+        NoAllocScope::assertCanAllocate();
+        cosTable.reserve(maxSize);
+        sinTable.reserve(maxSize);
+        bitReverseSwaps.reserve(maxSize / 2);
+        reservedSize = maxSize;
+    }
+
+    /**
+     * Build the tables for a transform size
+     *
+     * Allocates unless reserve() has made room for this size.
+     *
+     * @param newSize Transform size, a power of two >= 4
+     */
+    void configure(int newSize) {
+        if (newSize == n) {
+            return;
+        }
+        reserve(newSize);
+        n = newSize;
+        log2n = 0;
+        while ((1 << log2n) < n) {
+            log2n++;
+        }
+
+        // Twiddles W^j = e^(-2 pi i j / n); radix-4 stages reach j < 3n/4
+        cosTable.resize(n);
+        sinTable.resize(n);
+        for (int j = 0; j < n; j++) {
+            double theta = 2.0 * M_PI * j / n;
+            cosTable[j] = static_cast<float>(std::cos(theta));
+            sinTable[j] = static_cast<float>(-std::sin(theta));
+        }
+
+        // Only the index pairs that actually swap
+        bitReverseSwaps.clear();
+        for (int i = 0; i < n; i++) {
+            int j = 0;
+            for (int k = 0; k < log2n; k++) {
+                j = (j << 1) | ((i >> k) & 1);
+            }
+            if (j > i) {
+                bitReverseSwaps.push_back(std::make_pair(i, j));
+            }
+        }
+    }
+
+    int size() const {
+        return n;
+    }
+
+    /**
+     * Forward transform in place
+     */
+    void forward(float* re, float* im) const {
+        transform<false>(re, im);
+    }
+
+    /**
+     * Inverse transform in place, scaled by 1/n
+     */
+    void inverse(float* re, float* im) const {
+        transform<true>(re, im);
+        const float scale = 1.0f / n;
+        for (int i = 0; i < n; i++) {
+            re[i] *= scale;
+            im[i] *= scale;
+        }
+    }
+
+private:
+    int n = 0;
+    int log2n = 0;
+    int reservedSize = 0;
+    std::vector<float> cosTable;
+    std::vector<float> sinTable;
+    std::vector<std::pair<int, int>> bitReverseSwaps;
+
+    template <bool INVERSE>
+    void transform(float* re, float* im) const {
+        for (const std::pair<int, int>& s : bitReverseSwaps) {
+            std::swap(re[s.first], re[s.second]);
+            std::swap(im[s.first], im[s.second]);
+        }
+
+        // Odd number of stages: one twiddle-free radix-2 stage first
+        int h = 1;
+        if (log2n & 1) {
+            for (int m = 0; m < n; m += 2) {
+                float bR = re[m + 1];
+                float bI = im[m + 1];
+                re[m + 1] = re[m] - bR;
+                im[m + 1] = im[m] - bI;
+                re[m] += bR;
+                im[m] += bI;
+            }
+            h = 2;
+        }
+
+        // Radix-4 stages: each merges four sub-transforms of size h
+        const float sign = INVERSE ? -1.0f : 1.0f;
+        for (; h < n; h *= 4) {
+            const int stride = n / (4 * h);
+            for (int k = 0; k < h; k++) {
+                // Twiddles of size 4h, shared by every block of this stage
+                const float c1 = cosTable[2 * k * stride], s1 = sign * sinTable[2 * k * stride];
+                const float c2 = cosTable[k * stride], s2 = sign * sinTable[k * stride];
+                const float c3 = cosTable[3 * k * stride], s3 = sign * sinTable[3 * k * stride];
+
+                for (int m = 0; m < n; m += 4 * h) {
+                    const int i0 = m + k;
+                    const int i1 = i0 + h;
+                    const int i2 = i1 + h;
+                    const int i3 = i2 + h;
+
+                    // t1 = W^2k x1, t2 = W^k x2, t3 = W^3k x3
+                    float t1R = re[i1] * c1 - im[i1] * s1;
+                    float t1I = re[i1] * s1 + im[i1] * c1;
+                    float t2R = re[i2] * c2 - im[i2] * s2;
+                    float t2I = re[i2] * s2 + im[i2] * c2;
+                    float t3R = re[i3] * c3 - im[i3] * s3;
+                    float t3I = re[i3] * s3 + im[i3] * c3;
+
+                    float a0R = re[i0] + t1R, a0I = im[i0] + t1I;
+                    float a1R = re[i0] - t1R, a1I = im[i0] - t1I;
+                    float sR = t2R + t3R, sI = t2I + t3I;
+                    float dR = t2R - t3R, dI = t2I - t3I;
+
+                    // Rotate d by -i (forward) or +i (inverse)
+                    float rR = sign * dI;
+                    float rI = -sign * dR;
+
+                    re[i0] = a0R + sR;
+                    im[i0] = a0I + sI;
+                    re[i2] = a0R - sR;
+                    im[i2] = a0I - sI;
+                    re[i1] = a1R + rR;
+                    im[i1] = a1I + rI;
+                    re[i3] = a1R - rR;
+                    im[i3] = a1I - rI;
+                }
+            }
+        }
+    }
+};
+
+/**
+ * RealFFTPlan - Transform of real input through a half-size complex FFT
+ *
+ * The n real samples are packed as n/2 complex values (even samples real,
+ * odd samples imaginary), transformed with an n/2-point FFTPlan and split
+ * into the n/2 + 1 non-negative frequency bins with one post-twiddle pass.
+ * The negative frequencies of a real signal are never computed or stored.
+ */
+class RealFFTPlan {
+public:
+    /**
+     * Make room for the tables and scratch of transforms up to maxSize
+     * (allocates)
+     *
+     * @param maxSize Largest number of real samples
+     */
+    void reserve(int maxSize) {
+        if (maxSize <= reservedSize) {
+            return;
+        }
+        NoAllocScope::assertCanAllocate();
+        fft.reserve(maxSize / 2);
+        packedR.reserve(maxSize / 2);
+        packedI.reserve(maxSize / 2);
+        cosTable.reserve(maxSize / 2 + 1);
+        sinTable.reserve(maxSize / 2 + 1);
+        reservedSize = maxSize;
+    }
+
+    /**
+     * Build the tables and scratch for a transform size
+     *
+     * Allocates unless reserve() has made room for this size.
+     *
+     * @param newSize Number of real samples, a power of two >= 8
+     */
+    void configure(int newSize) {
+        if (newSize == n) {
+            return;
+        }
+        reserve(newSize);
+        n = newSize;
+        half = n / 2;
+        fft.configure(half);
+        packedR.assign(half, 0.0f);
+        packedI.assign(half, 0.0f);
+
+        // W^k = e^(-2 pi i k / n) for the split, k = 0 .. n/2
+        cosTable.resize(half + 1);
+        sinTable.resize(half + 1);
+        for (int k = 0; k <= half; k++) {
+            double theta = 2.0 * M_PI * k / n;
+            cosTable[k] = static_cast<float>(std::cos(theta));
+            sinTable[k] = static_cast<float>(-std::sin(theta));
+        }
+    }
+
+    int size() const {
+        return n;
+    }
+
+    /**
+     * @return Number of bins produced by forward(): n/2 + 1
+     */
+    int bins() const {
+        return half + 1;
+    }
+
+    /**
+     * Forward transform of n real samples into bins 0 .. n/2
+     *
+     * @param in Real input, n samples
+     * @param re Real part of each bin (n/2 + 1 values)
+     * @param im Imaginary part of each bin (n/2 + 1 values)
+     */
+    void forward(const float* in, float* re, float* im) {
+        for (int k = 0; k < half; k++) {
+            packedR[k] = in[2 * k];
+            packedI[k] = in[2 * k + 1];
+        }
+        fft.forward(packedR.data(), packedI.data());
+
+        // X[k] = E[k] + W^k O[k], where E and O are the transforms of the
+        // even and odd samples, recovered from Z[k] and conj(Z[n/2 - k])
+        for (int k = 0; k <= half; k++) {
+            int a = (k == half) ? 0 : k;
+            int b = (k == 0) ? 0 : half - k;
+            float zR = packedR[a], zI = packedI[a];
+            float cR = packedR[b], cI = -packedI[b];
+            float eR = 0.5f * (zR + cR), eI = 0.5f * (zI + cI);
+            // O = (Z - conj) / 2i
+            float oR = 0.5f * (zI - cI), oI = -0.5f * (zR - cR);
+            re[k] = eR + cosTable[k] * oR - sinTable[k] * oI;
+            im[k] = eI + cosTable[k] * oI + sinTable[k] * oR;
+        }
+    }
+
+    /**
+     * Inverse transform of bins 0 .. n/2 into n real samples, scaled by 1/n
+     *
+     * The imaginary parts of the DC and Nyquist bins are ignored, as they
+     * have no real-valued counterpart.
+     *
+     * @param re Real part of each bin (n/2 + 1 values)
+     * @param im Imaginary part of each bin (n/2 + 1 values)
+     * @param out Real output, n samples
+     */
+    void inverse(const float* re, const float* im, float* out) {
+        for (int k = 0; k < half; k++) {
+            float xR = re[k], xI = (k == 0) ? 0.0f : im[k];
+            float cR = re[half - k], cI = (k == 0) ? 0.0f : -im[half - k];
+            float eR = 0.5f * (xR + cR), eI = 0.5f * (xI + cI);
+            // O = (X - conj) / 2 * conj(W^k)
+            float dR = 0.5f * (xR - cR), dI = 0.5f * (xI - cI);
+            float oR = dR * cosTable[k] + dI * sinTable[k];
+            float oI = dI * cosTable[k] - dR * sinTable[k];
+            // Z = E + i O
+            packedR[k] = eR - oI;
+            packedI[k] = eI + oR;
+        }
+        fft.inverse(packedR.data(), packedI.data());
+        for (int k = 0; k < half; k++) {
+            out[2 * k] = packedR[k];
+            out[2 * k + 1] = packedI[k];
+        }
+    }
+
+private:
+    int n = 0;
+    int half = 0;
+    int reservedSize = 0;
+    FFTPlan fft;
+    std::vector<float> packedR;
+    std::vector<float> packedI;
+    std::vector<float> cosTable;
+    std::vector<float> sinTable;
+};
+
+/**
+ * StereoFFTPlan - Transforms of two real signals through one complex FFT
+ *
+ * The first signal is packed into the real part and the second into the
+ * imaginary part of one n-point complex FFT. Conjugate symmetry separates
+ * the two spectra: A[k] = (Z[k] + conj(Z[n - k])) / 2 and
+ * B[k] = (Z[k] - conj(Z[n - k])) / 2i. The inverse repacks them the same
+ * way, so a stereo pair costs one forward and one inverse transform.
+ */
+class StereoFFTPlan {
+public:
+    /**
+     * Make room for transforms up to maxSize (allocates)
+     *
+     * @param maxSize Largest number of real samples per signal
+     */
+    void reserve(int maxSize) {
+        if (maxSize <= reservedSize) {
+            return;
+        }
+        NoAllocScope::assertCanAllocate();
+        fft.reserve(maxSize);
+        packedR.reserve(maxSize);
+        packedI.reserve(maxSize);
+        reservedSize = maxSize;
+    }
+
+    /**
+     * Build the tables and scratch for a transform size
+     *
+     * Allocates unless reserve() has made room for this size.
+     *
+     * @param newSize Number of real samples per signal, a power of two >= 4
+     */
+    void configure(int newSize) {
+        if (newSize == n) {
+            return;
+        }
+        reserve(newSize);
+        n = newSize;
+        fft.configure(n);
+        packedR.assign(n, 0.0f);
+        packedI.assign(n, 0.0f);
+    }
+
+    int size() const {
+        return n;
+    }
+
+    /**
+     * @return Number of bins per signal: n/2 + 1
+     */
+    int bins() const {
+        return n / 2 + 1;
+    }
+
+    /**
+     * Forward transform of two signals into bins 0 .. n/2 each
+     *
+     * @param inA First real input, n samples
+     * @param inB Second real input, n samples
+     * @param reA Real part of the first spectrum (n/2 + 1 values)
+     * @param imA Imaginary part of the first spectrum
+     * @param reB Real part of the second spectrum
+     * @param imB Imaginary part of the second spectrum
+     */
+    void forward(const float* inA, const float* inB, float* reA, float* imA, float* reB, float* imB) {
+        std::copy(inA, inA + n, packedR.begin());
+        std::copy(inB, inB + n, packedI.begin());
+        fft.forward(packedR.data(), packedI.data());
+
+        for (int k = 0; k <= n / 2; k++) {
+            int m = (n - k) & (n - 1);
+            float zR = packedR[k], zI = packedI[k];
+            float cR = packedR[m], cI = -packedI[m];
+            reA[k] = 0.5f * (zR + cR);
+            imA[k] = 0.5f * (zI + cI);
+            reB[k] = 0.5f * (zI - cI);
+            imB[k] = -0.5f * (zR - cR);
+        }
+    }
+
+    /**
+     * Inverse transform of two spectra into n real samples each, scaled by 1/n
+     *
+     * The imaginary parts of the DC and Nyquist bins are ignored.
+     *
+     * @param reA Real part of the first spectrum (n/2 + 1 values)
+     * @param imA Imaginary part of the first spectrum
+     * @param reB Real part of the second spectrum
+     * @param imB Imaginary part of the second spectrum
+     * @param outA First real output, n samples
+     * @param outB Second real output, n samples
+     */
+    void inverse(const float* reA, const float* imA, const float* reB, const float* imB, float* outA, float* outB) {
+        const int half = n / 2;
+        // Z = A + iB for the non-negative frequencies...
+        for (int k = 0; k <= half; k++) {
+            bool edge = (k == 0 || k == half);
+            float aI = edge ? 0.0f : imA[k];
+            float bI = edge ? 0.0f : imB[k];
+            packedR[k] = reA[k] - bI;
+            packedI[k] = aI + reB[k];
+        }
+        // ...and conj(A) + i conj(B) mirrored into the negative ones
+        for (int k = half + 1; k < n; k++) {
+            int m = n - k;
+            packedR[k] = reA[m] + imB[m];
+            packedI[k] = reB[m] - imA[m];
+        }
+        fft.inverse(packedR.data(), packedI.data());
+        std::copy(packedR.begin(), packedR.end(), outA);
+        std::copy(packedI.begin(), packedI.end(), outB);
+    }
+
+private:
+    int n = 0;
+    int reservedSize = 0;
+    FFTPlan fft;
+    std::vector<float> packedR;
+    std::vector<float> packedI;
+};
+
+} // namespace CurveAndDrag
@@ -0,0 +1,204 @@
+#pragma once
+#include <rack.hpp>
+#include <cmath>
+#include <cstdint>
+#include <cstring>
+
+namespace CurveAndDrag {
+
+namespace simd = rack::simd;
+using simd::float_4;
+using simd::int32_4;
+
+/**
+ * Fast approximations of the transcendental functions on the audio path
+ *
+ * Each function has a float and a float_4 overload computing the same
+ * approximation, so scalar and polyphonic paths sound alike. Error bounds
+ * were measured against the double-precision library functions over the
+ * stated ranges.
+ */
+
+/**
+ * Polynomial cores shared by both overloads (arithmetic only)
+ */
+template <typename T>
+inline T tanhPade(T x) {
+    // [7/6] Pade approximant of tanh at 0
+    T x2 = x * x;
+    return x * (135135.0f + x2 * (17325.0f + x2 * (378.0f + x2))) /
+           (135135.0f + x2 * (62370.0f + x2 * (3150.0f + 28.0f * x2)));
+}
+
+template <typename T>
+inline T exp2Taylor(T f) {
+    // 2^f = e^(f ln 2), degree 6, for f in [-0.5, 0.5]
+    const float ln2 = 0.693147181f;
+    T p = 1.0f + f * (ln2 / 6.0f);
+    p = 1.0f + f * (ln2 / 5.0f) * p;
+    p = 1.0f + f * (ln2 / 4.0f) * p;
+    p = 1.0f + f * (ln2 / 3.0f) * p;
+    p = 1.0f + f * (ln2 / 2.0f) * p;
+    return 1.0f + f * ln2 * p;
+}
+
+template <typename T>
+inline T log2Mantissa(T m) {
+    // log2(m) = 2 atanh(s) / ln 2 with s = (m - 1) / (m + 1), for m in
+    // [sqrt(1/2), sqrt(2)) where |s| < 0.172
+    T s = (m - 1.0f) / (m + 1.0f);
+    T s2 = s * s;
+    T series = s * (1.0f + s2 * (1.0f / 3.0f + s2 * (1.0f / 5.0f + s2 * (1.0f / 7.0f + s2 * (1.0f / 9.0f)))));
+    return series * float(2.0 / M_LN2);
+}
+
+template <typename T>
+inline void sinCosQuarter(T r, T& sinR, T& cosR) {
+    // Minimax polynomials on [-pi/4, pi/4]
+    T r2 = r * r;
+    sinR = r + r * r2 * (-1.6666654611e-1f + r2 * (8.3321608736e-3f + r2 * -1.9515295891e-4f));
+    cosR = 1.0f - 0.5f * r2 + r2 * r2 * (4.166664568298827e-2f +
+           r2 * (-1.388731625493765e-3f + r2 * 2.443315711809948e-5f));
+}
+
+/**
+ * Hyperbolic tangent
+ *
+ * Clamped [7/6] Pade approximant; absolute error below 1e-4 everywhere,
+ * below 1e-6 for |x| < 2. Odd, and never exceeds +/-1.
+ */
+inline float fastTanh(float x) {
+    x = std::fmax(-4.97f, std::fmin(x, 4.97f));
+    return std::fmax(-1.0f, std::fmin(tanhPade(x), 1.0f));
+}
+
+inline float_4 fastTanh(float_4 x) {
+    x = simd::clamp(x, -4.97f, 4.97f);
+    return simd::clamp(tanhPade(x), -1.0f, 1.0f);
+}
+
+/**
+ * Base-2 exponential
+ *
+ * Rounds to the nearest integer power, built in the exponent bits, times
+ * a polynomial for the remainder; relative error below 3e-7. x is clamped
+ * to [-126, 127].
+ */
+inline float fastExp2(float x) {
+    x = std::fmax(-126.0f, std::fmin(x, 127.0f));
+    float whole = std::floor(x + 0.5f);
+    int32_t bits = (static_cast<int32_t>(whole) + 127) << 23;
+    float scale;
+    std::memcpy(&scale, &bits, sizeof(scale));
+    return exp2Taylor(x - whole) * scale;
+}
+
+inline float_4 fastExp2(float_4 x) {
+    x = simd::clamp(x, -126.0f, 127.0f);
+    float_4 whole = simd::floor(x + 0.5f);
+    float_4 scale = float_4::cast((int32_4(whole) + 127) << 23);
+    return exp2Taylor(x - whole) * scale;
+}
+
+/**
+ * Base-2 logarithm of a positive, normal value
+ *
+ * Splits off the exponent bits and evaluates an atanh series on the
+ * mantissa; absolute error below 2e-6.
+ */
+inline float fastLog2(float x) {
+    int32_t bits;
+    std::memcpy(&bits, &x, sizeof(bits));
+    float exponent = static_cast<float>((bits >> 23) - 127);
+    bits = (bits & 0x007fffff) | 0x3f800000;
+    float mantissa;
+    std::memcpy(&mantissa, &bits, sizeof(mantissa));
+    if (mantissa > float(M_SQRT2)) {
+        mantissa *= 0.5f;
+        exponent += 1.0f;
+    }
+    return exponent + log2Mantissa(mantissa);
+}
+
+inline float_4 fastLog2(float_4 x) {
+    int32_4 bits = int32_4::cast(x);
+    float_4 exponent = float_4((bits >> 23) - 127);
+    float_4 mantissa = float_4::cast((bits & 0x007fffff) | 0x3f800000);
+    float_4 high = mantissa > float(M_SQRT2);
+    mantissa = simd::ifelse(high, mantissa * 0.5f, mantissa);
+    exponent += simd::ifelse(high, 1.0f, 0.0f);
+    return exponent + log2Mantissa(mantissa);
+}
+
+/**
+ * Sine and cosine of the same angle
+ *
+ * Reduces by quarter turns and evaluates minimax polynomials on
+ * [-pi/4, pi/4]; absolute error is below 1e-7 for |x| <= 2 pi and grows
+ * with |x| (below 1e-6 for |x| <= 1e4), so wrap phases where possible.
+ */
+inline void fastSinCos(float x, float& sinOut, float& cosOut) {
+    // x = q * pi/2 + r, with pi/2 split in two for an exact-ish reduction
+    float q = std::floor(x * float(2.0 / M_PI) + 0.5f);
+    float r = x - q * 1.5703125f;
+    r = r - q * 4.8382679e-4f;
+    int quadrant = static_cast<int>(q - 4.0f * std::floor(q * 0.25f));
+
+    float sinR, cosR;
+    sinCosQuarter(r, sinR, cosR);
+    switch (quadrant) {
+        case 0: sinOut = sinR; cosOut = cosR; break;
+        case 1: sinOut = cosR; cosOut = -sinR; break;
+        case 2: sinOut = -sinR; cosOut = -cosR; break;
+        default: sinOut = -cosR; cosOut = sinR; break;
+    }
+}
+
+inline void fastSinCos(float_4 x, float_4& sinOut, float_4& cosOut) {
+    float_4 q = simd::floor(x * float(2.0 / M_PI) + 0.5f);
+    float_4 r = x - q * 1.5703125f;
+    r = r - q * 4.8382679e-4f;
+    float_4 quadrant = q - 4.0f * simd::floor(q * 0.25f);
+
+    float_4 sinR, cosR;
+    sinCosQuarter(r, sinR, cosR);
+
+    // Quadrants 1 and 3 swap sine and cosine; the signs follow the quadrant
+    float_4 odd = (quadrant == 1.0f) | (quadrant == 3.0f);
+    float_4 sinQ = simd::ifelse(odd, cosR, sinR);
+    float_4 cosQ = simd::ifelse(odd, sinR, cosR);
+    sinOut = simd::ifelse(quadrant >= 2.0f, -sinQ, sinQ);
+    cosOut = simd::ifelse((quadrant == 1.0f) | (quadrant == 2.0f), -cosQ, cosQ);
+}
+
+/**
+ * Sine, with the accuracy of fastSinCos()
+ */
+inline float fastSin(float x) {
+    float s, c;
+    fastSinCos(x, s, c);
+    return s;
+}
+
+inline float_4 fastSin(float_4 x) {
+    float_4 s, c;
+    fastSinCos(x, s, c);
+    return s;
+}
+
+/**
+ * Cosine, with the accuracy of fastSinCos()
+ */
+inline float fastCos(float x) {
+    float s, c;
+    fastSinCos(x, s, c);
+    return c;
+}
+
+inline float_4 fastCos(float_4 x) {
+    float_4 s, c;
+    fastSinCos(x, s, c);
+    return c;
+}
+
+} // namespace CurveAndDrag
@@ -0,0 +1,352 @@
+#pragma once
+#include <array>
+#include <cmath>
+#include "SimdUtils.hpp"
+
+namespace CurveAndDrag {
+
+/**
+ * Fractional-delay interpolation policies
+ *
+ * Each policy reads a buffer at a fractional position and is a template on
+ * the sample type so the same kernel serves float and float_4. Stateless
+ * policies supply a kernel over TAPS contiguous samples starting LEFT
+ * samples before the integer position; readTaps() gathers the taps and
+ * runs it. The kernel is a template on the value type, so for float_4 the
+ * weights of all four lanes are computed in one SIMD pass. Buffers must
+ * mirror at least TAPS - 1 samples past the end (see TRingBuffer) so
+ * kernels never check for wrap.
+ */
+
+/**
+ * Interpolation qualities selectable at run time, cheapest first
+ */
+enum InterpolationQuality {
+    INTERP_NONE,
+    INTERP_LINEAR,
+    INTERP_HERMITE,
+    INTERP_LAGRANGE4,
+    INTERP_LAGRANGE6,
+    INTERP_THIRAN,
+    INTERP_SINC,
+    NUM_INTERP_QUALITIES
+};
+
+/** Most taps read by any policy; buffers need this many guard samples */
+static constexpr int MAX_INTERP_TAPS = 8;
+
+/**
+ * Gather a policy's taps at a per-lane position and run its kernel
+ *
+ * @param policy Interpolator whose kernel() weights the taps
+ * @param buf Buffer with a guard region
+ * @param pos Read position in [0, capacity]
+ * @param mask Buffer capacity minus one
+ * @return Interpolated sample for each lane
+ */
+template <class Policy>
+inline float readTaps(const Policy& policy, const float* buf, float pos, int mask) {
+    int r0 = static_cast<int>(pos);
+    return policy.kernel(buf + ((r0 - Policy::LEFT) & mask), pos - r0);
+}
+
+template <class Policy>
+inline float_4 readTaps(const Policy& policy, const float_4* buf, float_4 pos, int mask) {
+    // Lanes are interleaved, so a lane's taps are 4 floats apart
+    const float* lanes = reinterpret_cast<const float*>(buf);
+    int32_4 r0 = int32_4(pos);
+    float_4 taps[Policy::TAPS];
+    for (int k = 0; k < 4; k++) {
+        const float* x = lanes + ((r0[k] - Policy::LEFT) & mask) * 4 + k;
+        for (int j = 0; j < Policy::TAPS; j++) {
+            taps[j][k] = x[j * 4];
+        }
+    }
+    return policy.kernel(taps, pos - float_4(r0));
+}
+
+/**
+ * N-point Lagrange kernel with taps at offsets -LEFT .. N - LEFT - 1
+ */
+template <int N, int LEFT, typename V>
+inline V lagrangeKernel(const V* x, V frac) {
+    V sum = 0.0f;
+    for (int j = 0; j < N; j++) {
+        V c = 1.0f;
+        for (int m = 0; m < N; m++) {
+            if (m != j) {
+                c *= (frac - static_cast<float>(m - LEFT)) * (1.0f / (j - m));
+            }
+        }
+        sum += c * x[j];
+    }
+    return sum;
+}
+
+/**
+ * No interpolation: nearest earlier sample
+ */
+template <typename T>
+struct NoInterpolation {
+    static constexpr int LEFT = 0;
+    static constexpr int TAPS = 1;
+
+    template <typename V>
+    V kernel(const V* x, V frac) const {
+        return x[0];
+    }
+
+    T read(const T* buf, T pos, int mask) {
+        return readTaps(*this, buf, pos, mask);
+    }
+
+    void reset() {}
+};
+
+/**
+ * Linear interpolation between the two neighbouring samples
+ */
+template <typename T>
+struct LinearInterpolation {
+    static constexpr int LEFT = 0;
+    static constexpr int TAPS = 2;
+
+    template <typename V>
+    V kernel(const V* x, V frac) const {
+        return x[0] + frac * (x[1] - x[0]);
+    }
+
+    T read(const T* buf, T pos, int mask) {
+        return readTaps(*this, buf, pos, mask);
+    }
+
+    void reset() {}
+};
+
+/**
+ * 4-point cubic Hermite (Catmull-Rom) interpolation
+ */
+template <typename T>
+struct HermiteInterpolation {
+    static constexpr int LEFT = 1;
+    static constexpr int TAPS = 4;
+
+    template <typename V>
+    V kernel(const V* x, V frac) const {
+        V ym1 = x[0];
+        V y0 = x[1];
+        V y1 = x[2];
+        V y2 = x[3];
+        V c1 = 0.5f * (y1 - ym1);
+        V c2 = ym1 - 2.5f * y0 + 2.0f * y1 - 0.5f * y2;
+        V c3 = 0.5f * (y2 - ym1) + 1.5f * (y0 - y1);
+        return ((c3 * frac + c2) * frac + c1) * frac + y0;
+    }
+
+    T read(const T* buf, T pos, int mask) {
+        return readTaps(*this, buf, pos, mask);
+    }
+
+    void reset() {}
+};
+
+/**
+ * 4-point (cubic) Lagrange interpolation
+ */
+template <typename T>
+struct Lagrange4Interpolation {
+    static constexpr int LEFT = 1;
+    static constexpr int TAPS = 4;
+
+    template <typename V>
+    V kernel(const V* x, V frac) const {
+        return lagrangeKernel<TAPS, LEFT>(x, frac);
+    }
+
+    T read(const T* buf, T pos, int mask) {
+        return readTaps(*this, buf, pos, mask);
+    }
+
+    void reset() {}
+};
+
+/**
+ * 6-point (quintic) Lagrange interpolation
+ */
+template <typename T>
+struct Lagrange6Interpolation {
+    static constexpr int LEFT = 2;
+    static constexpr int TAPS = 6;
+
+    template <typename V>
+    V kernel(const V* x, V frac) const {
+        return lagrangeKernel<TAPS, LEFT>(x, frac);
+    }
+
+    T read(const T* buf, T pos, int mask) {
+        return readTaps(*this, buf, pos, mask);
+    }
+
+    void reset() {}
+};
+
+/**
+ * First-order Thiran allpass interpolation
+ *
+ * Flat magnitude response, so highs are not dulled; the fractional delay
+ * is kept in [0.5, 1.5) where the allpass is stable and well behaved.
+ * When a modulated delay moves the input tap, the previous input is read
+ * from the sample before the new tap rather than remembered, so the
+ * recursion always sees consecutive samples and the output stays
+ * continuous. Stateful: each delay line needs its own instance.
+ */
+template <typename T>
+struct ThiranInterpolation {
+    static constexpr int TAPS = 3; // Reads up to two samples past the integer position
+
+    T read(const T* buf, T pos, int mask) {
+        return readAllpass(buf, pos, mask);
+    }
+
+    void reset() {
+        state = 0.0f;
+    }
+
+private:
+    T state = 0.0f;
+
+    /**
+     * One allpass step
+     *
+     * @param input Sample at the input tap
+     * @param previous Sample before the input tap
+     * @param d Fractional delay from the input tap, in [0.5, 1.5)
+     */
+    template <typename V>
+    V step(V input, V previous, V d) {
+        V a = (1.0f - d) / (1.0f + d);
+        V y = a * input + previous - a * state;
+        state = y;
+        return y;
+    }
+
+    float readAllpass(const float* buf, float pos, int mask) {
+        int r0 = static_cast<int>(pos);
+        // Delay measured back from the next sample: in (0, 1]
+        float d = 1.0f - (pos - r0);
+        const float* newest = buf + (r0 & mask) + 1;
+        if (d < 0.5f) {
+            d += 1.0f;
+            newest++;
+        }
+        return step(newest[0], newest[-1], d);
+    }
+
+    float_4 readAllpass(const float_4* buf, float_4 pos, int mask) {
+        const float* lanes = reinterpret_cast<const float*>(buf);
+        int32_4 r0 = int32_4(pos);
+        float_4 d = 1.0f - (pos - float_4(r0));
+        float_4 late = d < 0.5f;
+        d = simd::ifelse(late, d + 1.0f, d);
+        int lateLanes = simd::movemask(late);
+        float_4 input, previous;
+        for (int k = 0; k < 4; k++) {
+            int newest = (r0[k] & mask) + 1 + ((lateLanes >> k) & 1);
+            input[k] = lanes[newest * 4 + k];
+            previous[k] = lanes[(newest - 1) * 4 + k];
+        }
+        return step(input, previous, d);
+    }
+};
+
+/**
+ * Polyphase windowed-sinc table shared by every sinc interpolator
+ *
+ * 8 taps, Blackman window, PHASES fractional positions plus one so the
+ * kernel can interpolate between neighbouring phases. Each phase is
+ * normalised to unity DC gain.
+ */
+struct SincTable {
+    static constexpr int TAPS = 8;
+    static constexpr int PHASES = 256;
+    std::array<std::array<float, TAPS>, PHASES + 1> coefficients;
+
+    SincTable() {
+        const float halfWidth = TAPS / 2;
+        for (int p = 0; p <= PHASES; p++) {
+            float frac = static_cast<float>(p) / PHASES;
+            float sum = 0.0f;
+            for (int j = 0; j < TAPS; j++) {
+                // Distance from tap j (offset j - 3) to the read position
+                float t = (j - (TAPS / 2 - 1)) - frac;
+                float sinc = (std::fabs(t) < 1e-6f) ? 1.0f : std::sin(float(M_PI) * t) / (float(M_PI) * t);
+                float w = 0.42f + 0.5f * std::cos(float(M_PI) * t / halfWidth)
+                        + 0.08f * std::cos(2.0f * float(M_PI) * t / halfWidth);
+                coefficients[p][j] = sinc * w;
+                sum += coefficients[p][j];
+            }
+            for (int j = 0; j < TAPS; j++) {
+                coefficients[p][j] /= sum;
+            }
+        }
+    }
+
+    static const SincTable& get() {
+        static const SincTable table;
+        return table;
+    }
+};
+
+/**
+ * 8-tap polyphase windowed-sinc interpolation
+ *
+ * Keeps a pointer to the shared table, taken at construction, so reads do
+ * not go through the guarded static in SincTable::get().
+ */
+template <typename T>
+struct SincInterpolation {
+    static constexpr int LEFT = SincTable::TAPS / 2 - 1;
+    static constexpr int TAPS = SincTable::TAPS;
+
+    const SincTable* table = &SincTable::get();
+
+    float kernel(const float* x, float frac) const {
+        float phase = frac * SincTable::PHASES;
+        int p = static_cast<int>(phase);
+        float blend = phase - p;
+        const std::array<float, TAPS>& c0 = table->coefficients[p];
+        const std::array<float, TAPS>& c1 = table->coefficients[p + 1];
+        float sum = 0.0f;
+        for (int j = 0; j < TAPS; j++) {
+            sum += (c0[j] + blend * (c1[j] - c0[j])) * x[j];
+        }
+        return sum;
+    }
+
+    float_4 kernel(const float_4* x, float_4 frac) const {
+        float_4 phase = frac * static_cast<float>(SincTable::PHASES);
+        int32_4 p = int32_4(phase);
+        float_4 blend = phase - float_4(p);
+        const float* c0[4];
+        const float* c1[4];
+        for (int k = 0; k < 4; k++) {
+            c0[k] = table->coefficients[p[k]].data();
+            c1[k] = table->coefficients[p[k] + 1].data();
+        }
+        float_4 sum = 0.0f;
+        for (int j = 0; j < TAPS; j++) {
+            float_4 w0(c0[0][j], c0[1][j], c0[2][j], c0[3][j]);
+            float_4 w1(c1[0][j], c1[1][j], c1[2][j], c1[3][j]);
+            sum += (w0 + blend * (w1 - w0)) * x[j];
+        }
+        return sum;
+    }
+
+    T read(const T* buf, T pos, int mask) {
+        return readTaps(*this, buf, pos, mask);
+    }
+
+    void reset() {}
+};
+
+} // namespace CurveAndDrag
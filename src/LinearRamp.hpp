@@ -0,0 +1,53 @@
+#pragma once
+
+namespace CurveAndDrag {
+
+/**
+ * TLinearRamp - Per-sample linear interpolation between control-rate values
+ *
+ * Parameters are read once per control period; the audio path steps this
+ * ramp every sample so gains and times glide instead of jumping.
+ * T is float, or float_4 to ramp four poly voices at once.
+ */
+template <typename T>
+struct TLinearRamp {
+    T value = 0.0f;
+    T step = 0.0f;
+
+    /**
+     * Start ramping from the current value to a new target
+     *
+     * @param target Value to reach after n samples
+     * @param n Ramp length in samples
+     */
+    void setTarget(T target, int n) {
+        if (n > 0) {
+            step = (target - value) / static_cast<float>(n);
+        } else {
+            step = 0.0f;
+            value = target;
+        }
+    }
+
+    /**
+     * Jump straight to a value with no ramp
+     */
+    void reset(T newValue) {
+        value = newValue;
+        step = 0.0f;
+    }
+
+    /**
+     * Advance the ramp by one sample
+     *
+     * @return The ramped value for this sample
+     */
+    T next() {
+        value += step;
+        return value;
+    }
+};
+
+typedef TLinearRamp<float> LinearRamp;
+
+} // namespace CurveAndDrag
@@ -0,0 +1,589 @@
+#pragma once
+#include <rack.hpp>
+#include <array>
+#include "LinearRamp.hpp"
+#include "FastMath.hpp"
+#include "SimdUtils.hpp"
+#include "SpliceSearch.hpp"
+#include "PitchShifter.hpp"
+#include "RingBuffer.hpp"
+
+namespace CurveAndDrag {
+
+/**
+ * TPitchEngineState - Stereo ring buffer and read state for one pitch engine
+ *
+ * Holds the delay memory a time-domain pitch algorithm reads from, for one
+ * group of four poly voices. Aligned to a cache line so neighbouring groups
+ * and module instances never share one.
+ *
+ * The buffers are not allocated with the engine: prepareBuffers() builds
+ * them on the allocator thread the first time a group uses the algorithm,
+ * and the audio thread picks them up with publishBuffers(). Until then the
+ * engine has no memory and the group passes dry.
+ *
+ * @tparam SIZE Buffer length in frames (power of two)
+ */
+template <int SIZE>
+struct alignas(64) TPitchEngineState {
+    static_assert((SIZE & (SIZE - 1)) == 0, "Pitch engine buffer size must be a power of two");
+    static constexpr int MASK = SIZE - 1;
+
+    TRingBuffer<float_4, 0> left;
+    TRingBuffer<float_4, 0> right;
+    int writeIndex = 0;
+    float_4 leftPhase = 0.0f;   // Read phase or read position, per algorithm
+    float_4 rightPhase = 0.0f;
+    bool prepared = false;      // Background thread only
+
+    /**
+     * Build the buffers if they have not been (background thread only)
+     */
+    void prepareBuffers() {
+        if (!prepared) {
+            left.prepare(SIZE);
+            right.prepare(SIZE);
+            prepared = true;
+        }
+    }
+
+    /**
+     * Pick up prepared buffers at a block boundary (audio thread)
+     *
+     * @return true once both buffers are in place
+     */
+    bool publishBuffers() {
+        left.publish();
+        right.publish();
+        return !left.empty() && !right.empty();
+    }
+
+    /**
+     * Clear the buffers and rewind all positions
+     */
+    void reset() {
+        left.clear();
+        right.clear();
+        writeIndex = 0;
+        leftPhase = 0.0f;
+        rightPhase = 0.0f;
+    }
+};
+
+/**
+ * PitchBlockControl - Per-block controls shared by the time-domain engines
+ *
+ * Ratios and gain compensation glide across the block through the ramps,
+ * which the engine steps once per sample. The targets and the requested
+ * shifts are for decisions an engine makes once per block.
+ */
+struct PitchBlockControl {
+    TLinearRamp<float_4>& ratioL;
+    TLinearRamp<float_4>& ratioR;
+    TLinearRamp<float_4>& compL;
+    TLinearRamp<float_4>& compR;
+    float_4 ratioTargetL;   // Ratios reached at the end of the block
+    float_4 ratioTargetR;
+    float_4 centsL;         // Requested shift in cents
+    float_4 centsR;
+    float character;
+};
+
+/**
+ * BBDPitchEngine - Bucket brigade style pitch shifting
+ *
+ * Reads behind the write position with a read phase that advances by the
+ * inverse ratio, interpolated linearly.
+ */
+struct BBDPitchEngine : TPitchEngineState<8192> {
+    /**
+     * Shift one block in place; left and right share each sample's pass
+     *
+     * @param bufL Left samples of the group's four voices
+     * @param bufR Right samples of the group's four voices
+     * @param n Number of samples in the block
+     * @param control Ratios and gain compensation
+     */
+    void processBlock(float_4* bufL, float_4* bufR, int n, PitchBlockControl& control) {
+        for (int i = 0; i < n; i++) {
+            left.write(writeIndex, bufL[i]);
+            right.write(writeIndex, bufR[i]);
+            bufL[i] = tick(left.data(), leftPhase, control.ratioL.next(), control.compL.next());
+            bufR[i] = tick(right.data(), rightPhase, control.ratioR.next(), control.compR.next());
+            writeIndex = (writeIndex + 1) & MASK;
+        }
+    }
+
+private:
+    float_4 tick(const float_4* buf, float_4& phase, float_4 ratio, float_4 gainComp) {
+        phase += 1.0f / ratio;
+        float_4 readPos = static_cast<float>(writeIndex) - phase;
+        float_4 frac = phase - simd::floor(phase);
+        float_4 out = (readLanes(buf, readPos, 0, MASK) * (1.0f - frac) +
+                       readLanes(buf, readPos, 1, MASK) * frac) * gainComp;
+        
+        // Reset the phase to prevent accumulation
+        phase = simd::ifelse(phase > 4096.0f, phase - 4096.0f, phase);
+        return out;
+    }
+};
+
+/**
+ * GrainWindowTable - Hann window shared by the granular pitch engines
+ *
+ * SIZE points over one grain plus a guard point so lookups can interpolate
+ * up to a phase of one. Scaled so that GRAINS windows spaced evenly across
+ * a grain sum to exactly one.
+ */
+struct GrainWindowTable {
+    static constexpr int SIZE = 1024;
+    static constexpr int GRAINS = 2;
+    std::array<float, SIZE + 1> values;
+
+    GrainWindowTable() {
+        for (int i = 0; i <= SIZE; i++) {
+            float hann = 0.5f - 0.5f * std::cos(2.0f * float(M_PI) * i / SIZE);
+            values[i] = hann * (2.0f / GRAINS);
+        }
+    }
+
+    /**
+     * Window value at a grain phase
+     *
+     * @param phase Position within the grain, in [0, 1)
+     */
+    float_4 lookup(float_4 phase) const {
+        float_4 position = phase * static_cast<float>(SIZE);
+        float_4 out;
+        for (int k = 0; k < 4; k++) {
+            int i = static_cast<int>(position[k]);
+            float blend = position[k] - i;
+            out[k] = values[i] + blend * (values[i + 1] - values[i]);
+        }
+        return out;
+    }
+
+    static const GrainWindowTable& get() {
+        static const GrainWindowTable table;
+        return table;
+    }
+};
+
+/**
+ * GrainTaps - Overlapping windowed read taps for one channel
+ *
+ * GRAINS taps sweep the delay at (1 - ratio) samples per sample, each a
+ * fraction of a grain apart, so the read speed is the pitch ratio. A tap
+ * jumps back to the start of its sweep only where its window is zero, and
+ * the windows sum to one, so the output never fades out between grains.
+ * Each restart is pushed back by the SpliceSearch offset that puts the new
+ * grain in phase with the one it fades into. Reads are linearly
+ * interpolated at fractional positions.
+ */
+struct GrainTaps {
+    static constexpr int GRAINS = GrainWindowTable::GRAINS;
+    static constexpr int MIN_DELAY = 1;
+
+    /**
+     * Furthest a grain or its splice search reads behind the write position
+     *
+     * @param maxGrainSize Longest grain the engine uses
+     */
+    static constexpr int maxDelay(int maxGrainSize) {
+        return MIN_DELAY + maxGrainSize + SpliceSearch::MAX_PERIOD + SpliceSearch::DECIMATION + SpliceSearch::SPAN + 2;
+    }
+
+    float_4 phase = 0.0f;
+    float_4 offset[GRAINS] = {};   // Splice delay of each grain
+    SpliceSearch splice;
+
+    /**
+     * Read one sample and advance the taps
+     *
+     * @param buf Ring buffer the sample was just written to
+     * @param writeIndex Index of that sample
+     * @param mask Buffer size minus one
+     * @param grainSize Sweep length in samples
+     * @param ratio Pitch ratio
+     * @param spliceLanes Lanes whose restarts are aligned (bit k = lane k)
+     * @return Crossfaded grains
+     */
+    float_4 read(const float_4* buf, int writeIndex, int mask, float_4 grainSize, float_4 ratio, int spliceLanes) {
+        const GrainWindowTable& window = GrainWindowTable::get();
+        
+        // Offset by a whole buffer so the read positions stay positive
+        float_4 writePos = static_cast<float>(writeIndex + mask + 1);
+        float_4 grainPhase[GRAINS];
+        float_4 readPos[GRAINS];
+        float_4 out = 0.0f;
+        float_4 weightSum = 0.0f;
+        for (int grain = 0; grain < GRAINS; grain++) {
+            grainPhase[grain] = wrapUnit(phase + static_cast<float>(grain) / GRAINS);
+            readPos[grain] = writePos - (MIN_DELAY + grainPhase[grain] * grainSize + offset[grain]);
+            float_4 frac = readPos[grain] - simd::floor(readPos[grain]);
+            float_4 sample = readLanes(buf, readPos[grain], 0, mask) * (1.0f - frac) +
+                             readLanes(buf, readPos[grain], 1, mask) * frac;
+            
+            // The windows sum to one, so the last grain takes what is left
+            float_4 weight = (grain < GRAINS - 1) ? window.lookup(grainPhase[grain]) : 1.0f - weightSum;
+            weightSum += weight;
+            out += sample * weight;
+        }
+        
+        // The delay shrinks when shifting up and grows when shifting down
+        phase = wrapUnit(phase + (1.0f - ratio) / grainSize);
+        
+        // Grains that wrapped restart at the splice best aligned with the
+        // grain at the top of its window
+        for (int grain = 0; grain < GRAINS; grain++) {
+            float_4 nextPhase = wrapUnit(phase + static_cast<float>(grain) / GRAINS);
+            int restarted = simd::movemask(simd::abs(nextPhase - grainPhase[grain]) > 0.5f) & spliceLanes;
+            if (!restarted) {
+                continue;
+            }
+            const int partner = (grain + GRAINS / 2) % GRAINS;
+            for (int k = 0; k < 4; k++) {
+                if (restarted & (1 << k)) {
+                    float startPos = writePos[k] - (MIN_DELAY + nextPhase[k] * grainSize[k]);
+                    offset[grain][k] = splice.findOffset(buf, mask, k, readPos[partner][k], startPos);
+                }
+            }
+        }
+        return out;
+    }
+
+    void reset() {
+        phase = 0.0f;
+        for (float_4& grainOffset : offset) {
+            grainOffset = 0.0f;
+        }
+        splice.reset();
+    }
+
+private:
+    /**
+     * Wrap into [0, 1); x - floor(x) rounds up to 1 for tiny negative x
+     */
+    static float_4 wrapUnit(float_4 x) {
+        x -= simd::floor(x);
+        return simd::ifelse(x >= 1.0f, 0.0f, x);
+    }
+};
+
+/**
+ * H910PitchEngine - Harmonizer style overlapping-grain pitch shifting
+ */
+struct H910PitchEngine : TPitchEngineState<4096> {
+    static constexpr float MAX_GRAIN_SIZE = 1024.0f;
+    static_assert(GrainTaps::maxDelay(static_cast<int>(MAX_GRAIN_SIZE)) < 4096, "H910 buffer too short for its grains");
+
+    float_4 grainSize = 512.0f;   // Sweep length in samples, shared by L/R
+    GrainTaps tapsL;
+    GrainTaps tapsR;
+
+    /**
+     * Shift one block in place; left and right share each sample's pass
+     *
+     * @param bufL Left samples of the group's four voices
+     * @param bufR Right samples of the group's four voices
+     * @param n Number of samples in the block
+     * @param control Ratios and gain compensation
+     */
+    void processBlock(float_4* bufL, float_4* bufR, int n, PitchBlockControl& control) {
+        // Grain size based on pitch ratio for better quality; it glides
+        // across the block so the taps never jump
+        float_4 targetSize = simd::clamp(512.0f / simd::fmax(control.ratioTargetL, control.ratioTargetR), 128.0f, MAX_GRAIN_SIZE);
+        float_4 sizeStep = (targetSize - grainSize) / static_cast<float>(n);
+        
+        for (int i = 0; i < n; i++) {
+            grainSize += sizeStep;
+            left.write(writeIndex, bufL[i]);
+            right.write(writeIndex, bufR[i]);
+            bufL[i] = tapsL.read(left.data(), writeIndex, MASK, grainSize, control.ratioL.next(), 0xF) * control.compL.next();
+            bufR[i] = tapsR.read(right.data(), writeIndex, MASK, grainSize, control.ratioR.next(), 0xF) * control.compR.next();
+            writeIndex = (writeIndex + 1) & MASK;
+        }
+        grainSize = targetSize;
+    }
+
+    void reset() {
+        TPitchEngineState::reset();
+        grainSize = 512.0f;
+        tapsL.reset();
+        tapsR.reset();
+    }
+};
+
+/**
+ * VarispeedPitchEngine - Tape style variable speed playback
+ *
+ * The read position moves at the pitch ratio: a higher ratio reads faster
+ * and raises the pitch.
+ */
+struct VarispeedPitchEngine : TPitchEngineState<16384> {
+    /**
+     * Shift one block in place; left and right share each sample's pass
+     *
+     * @param bufL Left samples of the group's four voices
+     * @param bufR Right samples of the group's four voices
+     * @param n Number of samples in the block
+     * @param control Ratios and gain compensation
+     */
+    void processBlock(float_4* bufL, float_4* bufR, int n, PitchBlockControl& control) {
+        for (int i = 0; i < n; i++) {
+            left.write(writeIndex, bufL[i]);
+            right.write(writeIndex, bufR[i]);
+            bufL[i] = tick(left.data(), leftPhase, control.ratioL.next(), control.compL.next());
+            bufR[i] = tick(right.data(), rightPhase, control.ratioR.next(), control.compR.next());
+            writeIndex = (writeIndex + 1) & MASK;
+        }
+    }
+
+private:
+    float_4 tick(const float_4* buf, float_4& readPos, float_4 ratio, float_4 gainComp) {
+        readPos += ratio;
+        float_4 frac = readPos - simd::floor(readPos);
+        float_4 out = (readLanes(buf, readPos, 0, MASK) * (1.0f - frac) +
+                       readLanes(buf, readPos, 1, MASK) * frac) * gainComp;
+        readPos = simd::ifelse(readPos >= 16384.0f, readPos - 16384.0f, readPos);
+        return out;
+    }
+};
+
+/**
+ * HybridPitchEngine - H910-style grains for small shifts, saturated
+ * varispeed for large ones
+ *
+ * Each voice picks its branch per block from the size of its shift; only
+ * voices on the grain branch pay for splice searches.
+ */
+struct HybridPitchEngine : TPitchEngineState<8192> {
+    static constexpr float GRAIN_SIZE = 256.0f;
+    static_assert(GrainTaps::maxDelay(static_cast<int>(GRAIN_SIZE)) < 8192, "Hybrid buffer too short for its grains");
+
+    GrainTaps grainsL;
+    GrainTaps grainsR;
+
+    /**
+     * Shift one block in place; left and right share each sample's pass
+     *
+     * @param bufL Left samples of the group's four voices
+     * @param bufR Right samples of the group's four voices
+     * @param n Number of samples in the block
+     * @param control Ratios, gain compensation, shifts and character
+     */
+    void processBlock(float_4* bufL, float_4* bufR, int n, PitchBlockControl& control) {
+        float_4 smallShift = (simd::abs(control.centsL) < 100.0f) & (simd::abs(control.centsR) < 100.0f);
+        int grainLanes = simd::movemask(smallShift);
+        float drive = 1.0f + control.character * 0.5f;
+        
+        for (int i = 0; i < n; i++) {
+            left.write(writeIndex, bufL[i]);
+            right.write(writeIndex, bufR[i]);
+            bufL[i] = tick(left.data(), leftPhase, grainsL, smallShift, grainLanes, drive, control.ratioL.next(), control.compL.next());
+            bufR[i] = tick(right.data(), rightPhase, grainsR, smallShift, grainLanes, drive, control.ratioR.next(), control.compR.next());
+            writeIndex = (writeIndex + 1) & MASK;
+        }
+    }
+
+    void reset() {
+        TPitchEngineState::reset();
+        grainsL.reset();
+        grainsR.reset();
+    }
+
+private:
+    float_4 tick(const float_4* buf, float_4& phase, GrainTaps& grains, float_4 smallShift, int grainLanes,
+                 float drive, float_4 ratio, float_4 gainComp) {
+        // Small shifts: H910-style granular
+        float_4 grain = grains.read(buf, writeIndex, MASK, GRAIN_SIZE, ratio, grainLanes) * gainComp;
+        
+        // Large shifts: varispeed with BBD-style saturation
+        float_4 writePos = static_cast<float>(writeIndex);
+        phase += 1.0f / ratio;
+        float_4 var = fastTanh(readLanes(buf, writePos - phase, 0, MASK) * gainComp * drive);
+        phase = simd::ifelse(phase > 4096.0f, phase - 4096.0f, phase);
+        
+        return simd::ifelse(smallShift, grain, var);
+    }
+};
+
+/**
+ * PitchEngineGroup - State of every pitch algorithm for one voice group
+ *
+ * Each algorithm keeps its own buffer so switching modes resumes where the
+ * engine left off, as before. Buffers exist only for the algorithms the
+ * group has used: 256 KB for BBD and Hybrid, 128 KB for H910 and 512 KB
+ * for Varispeed.
+ */
+struct PitchEngineGroup {
+    BBDPitchEngine bbd;
+    H910PitchEngine h910;
+    VarispeedPitchEngine varispeed;
+    HybridPitchEngine hybrid;
+
+    /**
+     * Build buffers for the algorithms in a set (background thread only)
+     *
+     * @param modes Bit mask of pitch modes; bit m is mode m, with BBD,
+     *        H910, Varispeed and Hybrid as modes 0 to 3
+     */
+    void prepareBuffers(int modes) {
+        if (modes & (1 << 0)) {
+            bbd.prepareBuffers();
+        }
+        if (modes & (1 << 1)) {
+            h910.prepareBuffers();
+        }
+        if (modes & (1 << 2)) {
+            varispeed.prepareBuffers();
+        }
+        if (modes & (1 << 3)) {
+            hybrid.prepareBuffers();
+        }
+    }
+
+    /**
+     * Pick up prepared buffers for one algorithm (audio thread)
+     *
+     * @param mode Pitch mode, 0 to 3 as in prepareBuffers()
+     * @return true if that algorithm's buffers are in place
+     */
+    bool publishBuffers(int mode) {
+        switch (mode) {
+            case 0: return bbd.publishBuffers();
+            case 1: return h910.publishBuffers();
+            case 2: return varispeed.publishBuffers();
+            case 3: return hybrid.publishBuffers();
+            default: return false;
+        }
+    }
+
+    void reset() {
+        bbd.reset();
+        h910.reset();
+        varispeed.reset();
+        hybrid.reset();
+    }
+};
+
+/**
+ * CrossFeedbackState - Filtered L/R cross-feedback history for one voice group
+ */
+struct alignas(64) CrossFeedbackState {
+    float_4 prevLeft = 0.0f;
+    float_4 prevRight = 0.0f;
+    float_4 leftFilter = 0.0f;
+    float_4 rightFilter = 0.0f;
+
+    void reset() {
+        prevLeft = 0.0f;
+        prevRight = 0.0f;
+        leftFilter = 0.0f;
+        rightFilter = 0.0f;
+    }
+};
+
+/**
+ * SpectralVoice - Independent left/right phase vocoders for one poly voice
+ *
+ * Used by the Spectral pitch mode. Each vocoder owns about 655 KB of
+ * buffers and FFT tables, sized for the largest FFT, and the stereo FFT
+ * plan adds 165 KB: about 1.5 MB per voice. Voices are therefore only
+ * built once Spectral mode asks for them.
+ * Both vocoders are registered with the SpectralWorker for as long as the
+ * voice exists; construct and destroy voices off the audio thread.
+ *
+ * The pair is processed in lockstep through one stereo FFT. A stereo job
+ * in flight belongs to the left vocoder and covers both, so a reset or
+ * frame size change made while the worker runs it is deferred for both
+ * vocoders until the next block.
+ */
+struct SpectralVoice {
+    PitchShifter left;
+    PitchShifter right;
+    StereoFFTPlan fft;
+
+    explicit SpectralVoice(float sampleRate) {
+        left.setPitchMode(4);
+        right.setPitchMode(4);
+        fft.reserve(PitchShifter::MAX_FFT_SIZE);
+        configure(sampleRate);
+        SpectralWorker::get().attach(&left);
+        SpectralWorker::get().attach(&right);
+    }
+
+    ~SpectralVoice() {
+        SpectralWorker::get().detach(&left);
+        SpectralWorker::get().detach(&right);
+    }
+
+    /**
+     * Follow the engine sample rate; does not allocate once built
+     */
+    void configure(float sampleRate) {
+        left.configure(sampleRate);
+        right.configure(sampleRate);
+    }
+
+    /**
+     * Select the FFT frame size and overlap; does not allocate
+     */
+    void setFrameSize(int fftSize, int overlap) {
+        left.setFrameSize(fftSize, overlap);
+        right.setFrameSize(fftSize, overlap);
+    }
+
+    /**
+     * Run the pair's FFT work on the SpectralWorker thread
+     */
+    void setBackgroundProcessing(bool enabled) {
+        left.setBackgroundProcessing(enabled);
+        right.setBackgroundProcessing(enabled);
+    }
+
+    /**
+     * Use identity phase-locked synthesis in both vocoders
+     */
+    void setPhaseLocking(bool enabled) {
+        left.setPhaseLocking(enabled);
+        right.setPhaseLocking(enabled);
+    }
+
+    /**
+     * Process one block of the voice's left and right samples
+     *
+     * @param inL Left input samples
+     * @param inR Right input samples
+     * @param outL Left output samples (may alias inL)
+     * @param outR Right output samples (may alias inR)
+     * @param n Number of samples in the block
+     */
+    void processBlock(const float* inL, const float* inR, float* outL, float* outR, int n) {
+        PitchShifter::processStereoBlock(left, right, fft, inL, inR, outL, outR, n);
+    }
+
+    void reset() {
+        left.reset();
+        right.reset();
+    }
+};
+
+/**
+ * PitchSmoothingState - Control-rate smoothing of the pitch parameters
+ */
+struct PitchSmoothingState {
+    float basePitch = 0.0f;
+    float detuneL = 0.0f;
+    float detuneR = 0.0f;
+    float drift = 0.0f;
+
+    void reset() {
+        basePitch = 0.0f;
+        detuneL = 0.0f;
+        detuneR = 0.0f;
+        drift = 0.0f;
+    }
+};
+
+} // namespace CurveAndDrag
@@ -1,8 +1,16 @@
 #pragma once
 #include <rack.hpp>
 #include <vector>
+#include <algorithm>
+#include <atomic>
 #include <complex>
 #include <cmath>
+#include <cstdint>
+#include "FFT.hpp"
+#include "AlignedArena.hpp"
+#include "FastMath.hpp"
+#include "SimdUtils.hpp"
+#include "SpectralWorker.hpp"
 
 namespace CurveAndDrag {
 
@@ -11,16 +19,35 @@ namespace CurveAndDrag {
  * 
  * Implements a real-time phase vocoder algorithm for high-quality
  * pitch shifting with minimal artifacts.
+ * 
+ * With background processing enabled, each hop's windowed frame is posted
+ * to the SpectralWorker and its synthesized frame is overlap-added one hop
+ * later, so the FFT work leaves the engine thread at the cost of hopSize
+ * samples of extra latency. The hand-off is a single-slot SPSC queue: only
+ * one job per vocoder is ever in flight, and the audio thread never waits on
+ * it. A hop that finds the worker still busy queues its analysis frame for
+ * the next job, so the vocoder still sees every frame and its phases stay
+ * continuous; frames that come back late are overlap-added where they were
+ * due, minus the part already played, which fades in. A reset or frame
+ * size change that arrives while the worker holds the spectral state is
+ * deferred to the next block.
+ * 
+ * processStereoBlock() runs a left/right pair in lockstep so both channels
+ * share one complex FFT per transform.
  */
-class PitchShifter {
+class PitchShifter : public SpectralJobClient {
 public:
     PitchShifter() {
         // Initialize with default values
         sampleRate = 44100.f;
         bufferSize = 2048;
         hopSize = 512;
+        requestedSize = bufferSize;
+        requestedHop = hopSize;
         pitchShift = 1.0f;
+        basePitchShift = 1.0f;
         detuneDriftAmount = 0.0f;
+        detuneDriftRate = 0.0f;
         detuneDriftPhase = 0.0f;
         pitchMode = 0;              // Default to BBD mode
         characterAmount = 0.0f;     // No character processing by default
@@ -29,49 +56,20 @@ public:
         reset();
     }
 
+    PitchShifter(const PitchShifter&) = delete;
+    PitchShifter& operator=(const PitchShifter&) = delete;
+
     /**
      * Reset all internal buffers and state
+     * 
+     * Every buffer is carved from one arena sized for MAX_FFT_SIZE, so only
+     * the first reset allocates; later resets just clear it. Deferred to the
+     * next block while the worker is synthesizing a frame.
      */
     void reset() {
-        // Allocate input and output buffers
-        inputBuffer.resize(bufferSize * 2, 0.0f);
-        outputBuffer.resize(bufferSize * 2, 0.0f);
-        
-        // Initialize phase data
-        analysisPhase.resize(bufferSize / 2 + 1, 0.0f);
-        synthesisPhase.resize(bufferSize / 2 + 1, 0.0f);
-        
-        // Reset counters
-        inputPos = 0;
-        outputPos = 0;
-        frameCount = 0;
-        
-        // Allocate FFT data
-        fftBufferR.resize(bufferSize);
-        fftBufferI.resize(bufferSize);
-        
-        // Initialize windows
-        analysisWindow.resize(bufferSize);
-        synthesisWindow.resize(bufferSize);
-        
-        // Create Hann window
-        for (int i = 0; i < bufferSize; i++) {
-            float windowValue = 0.5f - 0.5f * std::cos(2.0f * M_PI * i / bufferSize);
-            analysisWindow[i] = windowValue;
-            synthesisWindow[i] = windowValue;
-        }
-        
-        // Normalize windows for perfect reconstruction
-        float windowSum = 0.0f;
-        for (int i = 0; i < bufferSize; i += hopSize) {
-            windowSum += analysisWindow[i] * synthesisWindow[i];
-        }
-        
-        float windowScaleFactor = 1.0f / windowSum * hopSize;
-        for (int i = 0; i < bufferSize; i++) {
-            analysisWindow[i] *= windowScaleFactor;
-            synthesisWindow[i] *= windowScaleFactor;
-        }
+        resetPending = true;
+        changesPending = true;
+        applyPendingChanges();
     }
 
     /**
@@ -86,6 +84,100 @@ public:
         }
     }
 
+    /**
+     * Select the FFT frame size and overlap
+     * 
+     * Resets the vocoder if either changes. Does not allocate: the arena and
+     * FFT tables are sized for MAX_FFT_SIZE.
+     * 
+     * @param fftSize Frame size, a power of two (MIN_FFT_SIZE to MAX_FFT_SIZE)
+     * @param overlap Frames overlapping each sample (2, 4 or 8)
+     */
+    void setFrameSize(int fftSize, int overlap) {
+        int newSize = MIN_FFT_SIZE;
+        while (newSize < fftSize && newSize < MAX_FFT_SIZE) {
+            newSize *= 2;
+        }
+        int newHop = newSize / clamp(overlap, MIN_OVERLAP, MAX_OVERLAP);
+        if (newSize == requestedSize && newHop == requestedHop) {
+            return;
+        }
+        // The worker reads the sizes while it synthesizes a frame, so they
+        // change with the reset
+        requestedSize = newSize;
+        requestedHop = newHop;
+        resetPending = true;
+        changesPending = true;
+        applyPendingChanges();
+    }
+
+    int getFftSize() const {
+        return bufferSize;
+    }
+
+    int getHopSize() const {
+        return hopSize;
+    }
+
+    // Supported frame sizes and overlap factors
+    static constexpr int MIN_FFT_SIZE = 256;
+    static constexpr int MAX_FFT_SIZE = 8192;
+    static constexpr int MIN_OVERLAP = 2;
+    static constexpr int MAX_OVERLAP = 8;
+    static constexpr int MAX_HARMONY_VOICES = 3;   // Added to the main voice
+
+    /**
+     * Run the spectral work of each hop on the SpectralWorker thread
+     * 
+     * Adds hopSize samples of latency while enabled. Disabling it overlap-adds
+     * the frame in flight first, so no hop is dropped; if the worker is still
+     * synthesizing that frame, the switch waits for a later block.
+     * 
+     * @param enabled true to post frames to the worker
+     */
+    void setBackgroundProcessing(bool enabled) {
+        if (enabled == backgroundRequested) {
+            return;
+        }
+        backgroundRequested = enabled;
+        changesPending = true;
+        applyPendingChanges();
+    }
+
+    bool isBackgroundProcessing() const {
+        return backgroundProcessing;
+    }
+
+    /**
+     * Latency from input to output in samples, for the current mode
+     */
+    int getLatencySamples() const {
+        return latencySamples(bufferSize, hopSize, backgroundProcessing);
+    }
+
+    /**
+     * Latency of a vocoder configuration in samples
+     * 
+     * @param fftSize Frame size
+     * @param hop Hop size
+     * @param background true if frames run on the SpectralWorker
+     */
+    static int latencySamples(int fftSize, int hop, bool background) {
+        return fftSize - 1 + (background ? hop : 0);
+    }
+
+    /**
+     * Run the posted frame unless the audio thread already claimed it
+     * (SpectralWorker thread)
+     */
+    void runPostedJob() override {
+        int expected = JOB_POSTED;
+        if (jobState.compare_exchange_strong(expected, JOB_WORKING, std::memory_order_acquire)) {
+            runJob();
+            jobState.store(JOB_DONE, std::memory_order_release);
+        }
+    }
+
     /**
      * Set pitch shift amount in semitones
      * 
@@ -93,7 +185,8 @@ public:
      */
     void setPitchShiftSemitones(float semitones) {
         // Convert semitones to ratio
-        pitchShift = std::pow(2.0f, semitones / 12.0f);
+        basePitchShift = fastExp2(semitones / 12.0f);
+        pitchShift = basePitchShift;
     }
 
     /**
@@ -103,7 +196,39 @@ public:
      */
     void setPitchShiftCents(float cents) {
         // Convert cents to ratio
-        pitchShift = std::pow(2.0f, cents / 1200.0f);
+        basePitchShift = fastExp2(cents / 1200.0f);
+        pitchShift = basePitchShift;
+    }
+
+    /**
+     * Add harmony voices that share this vocoder's analysis
+     * 
+     * Each harmony voice is synthesized from the same analysis frame at its
+     * own ratio, and all voices are summed before the single inverse FFT,
+     * so a voice costs one bin-remapping pass rather than a whole vocoder.
+     * The sum is scaled by 1/sqrt(voices) to keep the level steady. Harmony
+     * voices follow the detune drift of the main voice.
+     * 
+     * @param cents Shift of each harmony voice in cents (-2400 to 2400)
+     * @param count Number of harmony voices (0 to MAX_HARMONY_VOICES)
+     */
+    void setHarmonyCents(const float* cents, int count) {
+        harmonyCount = clamp(count, 0, MAX_HARMONY_VOICES);
+        for (int v = 0; v < harmonyCount; v++) {
+            harmonyShift[v] = fastExp2(clamp(cents[v], -2400.0f, 2400.0f) / 1200.0f);
+        }
+    }
+
+    /**
+     * Lock non-peak bins to the phase of their spectral peak
+     * 
+     * Identity phase locking keeps partials coherent, so 2x overlap sounds
+     * about as clean as 4x without it, at half the frames per second.
+     * 
+     * @param enabled true for phase-locked synthesis
+     */
+    void setPhaseLocking(bool enabled) {
+        phaseLocking = enabled;
     }
 
     /**
@@ -118,12 +243,12 @@ public:
     }
 
     /**
-     * Set pitch shifting mode (BBD, H910, Varispeed, Hybrid)
+     * Set pitch shifting mode (BBD, H910, Varispeed, Hybrid, Spectral)
      * 
-     * @param mode Pitch shifting mode
+     * @param mode Pitch shifting mode; Spectral (4) adds no coloration
      */
     void setPitchMode(int mode) {
-        pitchMode = clamp(mode, 0, 3);
+        pitchMode = clamp(mode, 0, 4);
     }
 
     /**
@@ -143,6 +268,10 @@ public:
      * @return Processed output sample
      */
     float process(float input, int channel) {
+        if (changesPending) {
+            applyPendingChanges();
+        }
+        
         // Update LFO for detuning
         updateDetuneDrift();
         
@@ -151,23 +280,113 @@ public:
         
         // Write input to buffer
         inputBuffer[inputPos] = processedInput;
-        inputPos = (inputPos + 1) % inputBuffer.size();
+        inputPos = (inputPos + 1) % ringSize;
         
         // Every hopSize samples, perform FFT processing
         if ((inputPos % hopSize) == 0) {
-            processFrame();
+            processHop();
             frameCount++;
         }
         
         // Read from output buffer
         float output = outputBuffer[outputPos];
         outputBuffer[outputPos] = 0.0f; // Clear the buffer
-        outputPos = (outputPos + 1) % outputBuffer.size();
+        outputPos = (outputPos + 1) % ringSize;
+        outputCount++;
         
         // Apply character-based post-processing
         return applyCharacterPostProcessing(output);
     }
 
+    /**
+     * Process a block of audio samples through the pitch shifter
+     * 
+     * The block is split into runs that end on hop boundaries, so buffer
+     * positions wrap without a modulo and the hop check runs once per run.
+     * 
+     * @param in Input samples
+     * @param out Output samples (may alias the input)
+     * @param n Number of samples in the block
+     * @param channel Channel index (0 = left, 1 = right)
+     */
+    void processBlock(const float* in, float* out, int n, int channel = 0) {
+        if (changesPending) {
+            applyPendingChanges();
+        }
+        int i = 0;
+        
+        while (i < n) {
+            int run = std::min(hopSize - (inputPos % hopSize), n - i);
+            
+            for (int k = 0; k < run; k++, i++) {
+                writeInput(in[i]);
+                
+                // Only the last sample of a run can land on a hop boundary
+                if (k == run - 1 && (inputPos % hopSize) == 0) {
+                    processHop();
+                    frameCount++;
+                }
+                
+                out[i] = readOutput();
+            }
+        }
+    }
+
+    /**
+     * Process a block through a left/right pair of vocoders in lockstep
+     * 
+     * Both channels reach each hop boundary together, so their frames share
+     * one complex FFT each way (see StereoFFTPlan). In background mode the
+     * left vocoder's job slot carries the pair. Falls back to two mono
+     * passes if the vocoders are not configured identically.
+     * 
+     * @param left Left vocoder
+     * @param right Right vocoder, same frame size, hop and position
+     * @param plan Stereo transform shared by the pair
+     * @param inL Left input samples
+     * @param inR Right input samples
+     * @param outL Left output samples (may alias inL)
+     * @param outR Right output samples (may alias inR)
+     * @param n Number of samples in the block
+     */
+    static void processStereoBlock(PitchShifter& left, PitchShifter& right, StereoFFTPlan& plan,
+                                   const float* inL, const float* inR, float* outL, float* outR, int n) {
+        // Left first: its job slot may carry the right vocoder's frame too
+        if (left.changesPending) {
+            left.applyPendingChanges();
+        }
+        if (right.changesPending) {
+            right.applyPendingChanges();
+        }
+        if (left.bufferSize != right.bufferSize || left.hopSize != right.hopSize || left.inputPos != right.inputPos) {
+            left.processBlock(inL, outL, n, 0);
+            right.processBlock(inR, outR, n, 1);
+            return;
+        }
+        plan.configure(left.bufferSize);
+        
+        const int hop = left.hopSize;
+        int i = 0;
+        
+        while (i < n) {
+            int run = std::min(hop - (left.inputPos % hop), n - i);
+            
+            for (int k = 0; k < run; k++, i++) {
+                left.writeInput(inL[i]);
+                right.writeInput(inR[i]);
+                
+                if (k == run - 1 && (left.inputPos % hop) == 0) {
+                    processStereoHop(left, right, plan);
+                    left.frameCount++;
+                    right.frameCount++;
+                }
+                
+                outL[i] = left.readOutput();
+                outR[i] = right.readOutput();
+            }
+        }
+    }
+
     /**
      * Process a single audio sample through the pitch shifter (legacy interface)
      * 
@@ -183,7 +402,8 @@ private:
     float sampleRate;
     int bufferSize;
     int hopSize;
-    float pitchShift;
+    float pitchShift;            // Current shift including detune drift
+    float basePitchShift;        // Shift set by setPitchShift*()
     
     // Detuning parameters
     float detuneDriftAmount;
@@ -191,7 +411,7 @@ private:
     float detuneDriftPhase;
     
     // Pitch mode and character parameters
-    int pitchMode;               // 0=BBD, 1=H910, 2=Varispeed, 3=Hybrid
+    int pitchMode;               // 0=BBD, 1=H910, 2=Varispeed, 3=Hybrid, 4=Spectral
     float characterAmount;       // Character/vintage modeling amount
     
     // Buffer positions
@@ -199,19 +419,88 @@ private:
     int outputPos;
     int frameCount;
     
+    // Character post-processing filter states
+    float bbdLowpass = 0.0f;
+    float h910Highpass = 0.0f;
+    float varisLowpass = 0.0f;
+    
+    // Synthesis voices: the main shift plus the harmony voices
+    static constexpr int MAX_SYNTH_VOICES = MAX_HARMONY_VOICES + 1;
+    struct ShiftSet {
+        int count = 1;
+        float ratio[MAX_SYNTH_VOICES] = {1.0f, 1.0f, 1.0f, 1.0f};
+        bool phaseLocked = false;
+    };
+    bool phaseLocking = false;
+    std::vector<int> peakBins;   // Spectral peaks of the current frame
+    int harmonyCount = 0;
+    float harmonyShift[MAX_HARMONY_VOICES] = {};
+    
+    // Background processing: one frame slot shared with the SpectralWorker
+    enum JobState {
+        JOB_EMPTY,      // Slot free (audio thread owns it)
+        JOB_POSTED,     // Frame waiting; either thread may claim it
+        JOB_WORKING,    // Claimed and being synthesized
+        JOB_DONE        // Synthesized frame ready for overlap-add
+    };
+    bool backgroundProcessing = false;
+    std::atomic<int> jobState{JOB_EMPTY};
+    static constexpr int MAX_JOB_FRAMES = 2;    // A queued frame plus the current one
+    static constexpr int LATE_FADE = 64;        // Fade-in of a late frame's cut, in samples
+    int jobFrames = 0;                          // Frames in the job, oldest first
+    uint32_t jobDue[MAX_JOB_FRAMES] = {};       // outputCount at which each frame starts
+    bool frameQueued = false;                   // Analysis frame waiting for the next job
+    uint32_t queuedDue = 0;
+    uint32_t outputCount = 0;                   // Samples read out since the last reset
+    ShiftSet jobShifts;
+    PitchShifter* jobPartner = nullptr;     // Right channel of a stereo job
+    StereoFFTPlan* jobStereoPlan = nullptr;
+    PitchShifter* jobHolder = this;         // Vocoder whose job covers this one's buffers
+    
+    // Changes deferred while the worker holds the spectral state
+    bool changesPending = false;
+    bool resetPending = false;
+    bool backgroundRequested = false;
+    int requestedSize;
+    int requestedHop;
+    
+    // All buffers below point into the arena
+    AlignedArena arena;
+    
     // Audio buffers
-    std::vector<float> inputBuffer;
-    std::vector<float> outputBuffer;
+    int ringSize = 0;
+    float* inputBuffer = nullptr;
+    float* outputBuffer = nullptr;
     
     // FFT data
-    std::vector<float> fftBufferR;
-    std::vector<float> fftBufferI;
-    std::vector<float> analysisPhase;
-    std::vector<float> synthesisPhase;
+    RealFFTPlan fft;
+    float* frameBuffer = nullptr;       // Windowed time-domain frame
+    float* jobFrame[MAX_JOB_FRAMES] = {};   // Frames handed to the worker
+    float* queuedFrame = nullptr;       // Frame analysed while the worker was busy
+    float* fftBufferR = nullptr;
+    float* fftBufferI = nullptr;
+    float* analysisPhase = nullptr;
+    float* synthesisPhase[MAX_SYNTH_VOICES] = {};   // One per synthesis voice
+    
+    // Per-frame spectral scratch
+    float* magnitude = nullptr;
+    float* phase = nullptr;
+    float* phaseDiff = nullptr;
+    float* synthMagnitude = nullptr;
+    float* synthPhaseAdvance = nullptr;
     
     // Windows
-    std::vector<float> analysisWindow;
-    std::vector<float> synthesisWindow;
+    float* analysisWindow = nullptr;
+    float* synthesisWindow = nullptr;
+
+    /**
+     * Arena size for every buffer of a given FFT size
+     */
+    static constexpr size_t arenaFloats(int fftSize) {
+        return 2 * AlignedArena::sliceFloats(fftSize * 2)        // input, output
+             + 6 * AlignedArena::sliceFloats(fftSize)            // frames, windows
+             + (8 + MAX_SYNTH_VOICES) * AlignedArena::sliceFloats(fftSize / 2 + 1);   // spectra, phases, scratch
+    }
 
     /**
      * Update the detune drift LFO
@@ -225,172 +514,560 @@ private:
             }
             
             // Calculate detune factor - subtle sine modulation
-            float detuneModulation = std::sin(2.0f * M_PI * detuneDriftPhase);
+            float detuneModulation = fastSin(2.0f * float(M_PI) * detuneDriftPhase);
             float detuneAmount = 1.0f + detuneModulation * detuneDriftAmount * 0.01f;
             
-            // Apply to the pitch shift
-            float basePitchShift = pitchShift;
+            // Modulate around the set shift (never compound it)
             pitchShift = basePitchShift * detuneAmount;
         }
     }
 
     /**
-     * Process a complete frame using FFT-based phase vocoder
+     * Ratios of the synthesis voices for the next frame
      */
-    void processFrame() {
-        // Extract frame from input buffer with analysis window
-        int frameStart = (inputPos - hopSize + inputBuffer.size()) % inputBuffer.size();
-        for (int i = 0; i < bufferSize; i++) {
-            int bufIdx = (frameStart + i) % inputBuffer.size();
-            float windowedSample = inputBuffer[bufIdx] * analysisWindow[i];
-            fftBufferR[i] = windowedSample;
-            fftBufferI[i] = 0.0f;
+    ShiftSet currentShifts() const {
+        ShiftSet shifts;
+        shifts.count = 1 + harmonyCount;
+        shifts.phaseLocked = phaseLocking;
+        shifts.ratio[0] = pitchShift;
+        const float drift = pitchShift / basePitchShift;
+        for (int v = 0; v < harmonyCount; v++) {
+            shifts.ratio[1 + v] = harmonyShift[v] * drift;
+        }
+        return shifts;
+    }
+
+    /**
+     * Advance the drift LFO and write one input sample
+     */
+    void writeInput(float input) {
+        updateDetuneDrift();
+        inputBuffer[inputPos] = applyCharacterProcessing(input);
+        if (++inputPos >= ringSize) {
+            inputPos = 0;
+        }
+    }
+
+    /**
+     * Read and clear one output sample
+     */
+    float readOutput() {
+        float output = outputBuffer[outputPos];
+        outputBuffer[outputPos] = 0.0f;
+        if (++outputPos >= ringSize) {
+            outputPos = 0;
         }
+        outputCount++;
+        return applyCharacterPostProcessing(output);
+    }
+
+    /**
+     * Hop boundary: analyse the latest frame and overlap-add a synthesized one
+     * 
+     * In background mode the frame posted at the previous hop is collected
+     * and overlap-added, and the new frame is posted in its place.
+     */
+    void processHop() {
+        NoAllocScope noAlloc;
         
-        // Perform forward FFT
-        performFFT(fftBufferR, fftBufferI, bufferSize, false);
+        // A stereo job from an earlier block may still cover these buffers
+        if (jobHolder != this) {
+            if (!jobHolder->collectJob()) {
+                queueFrame();
+                return;
+            }
+            jobHolder = this;
+        }
         
-        // Convert to polar coordinates
-        std::vector<float> magnitude(bufferSize / 2 + 1);
-        std::vector<float> phase(bufferSize / 2 + 1);
+        if (!backgroundProcessing) {
+            readFrame(frameBuffer);
+            spectralFrame(frameBuffer, currentShifts());
+            overlapAdd(frameBuffer);
+            return;
+        }
         
-        for (int i = 0; i <= bufferSize / 2; i++) {
-            magnitude[i] = std::sqrt(fftBufferR[i] * fftBufferR[i] + fftBufferI[i] * fftBufferI[i]);
-            phase[i] = std::atan2(fftBufferI[i], fftBufferR[i]);
+        // Never wait for the worker: if it still has the last job, this
+        // hop's frame goes into the next one
+        if (!collectJob()) {
+            queueFrame();
+            return;
         }
+        loadJob();
+        jobShifts = currentShifts();
+        jobPartner = nullptr;
+        jobState.store(JOB_POSTED, std::memory_order_release);
+        SpectralWorker::get().notify();
+    }
+
+    /**
+     * Hop boundary of a stereo pair: processHop() for both channels at once
+     */
+    static void processStereoHop(PitchShifter& left, PitchShifter& right, StereoFFTPlan& plan) {
+        NoAllocScope noAlloc;
         
-        // Calculate phase difference and instantaneous frequency
-        std::vector<float> phaseDiff(bufferSize / 2 + 1);
-        for (int i = 0; i <= bufferSize / 2; i++) {
-            float expectedPhase = i * 2.0f * M_PI * hopSize / bufferSize;
-            float phaseDelta = phase[i] - analysisPhase[i];
-            
-            // Unwrap phase difference
-            phaseDiff[i] = phaseDelta - expectedPhase;
-            phaseDiff[i] = phaseDiff[i] - std::round(phaseDiff[i] / (2.0f * M_PI)) * 2.0f * M_PI;
-            phaseDiff[i] = phaseDiff[i] + expectedPhase;
-            
-            // Store current phase for next frame
-            analysisPhase[i] = phase[i];
+        if (!left.backgroundProcessing) {
+            left.readFrame(left.frameBuffer);
+            right.readFrame(right.frameBuffer);
+            stereoSpectralFrame(left, right, plan, left.frameBuffer, right.frameBuffer,
+                                left.currentShifts(), right.currentShifts());
+            left.overlapAdd(left.frameBuffer);
+            right.overlapAdd(right.frameBuffer);
+            return;
         }
         
-        // Apply pitch shifting in frequency domain
-        for (int i = 0; i <= bufferSize / 2; i++) {
-            float newBinPos = i * pitchShift;
-            int lowerBin = static_cast<int>(std::floor(newBinPos));
-            int upperBin = lowerBin + 1;
-            float fraction = newBinPos - lowerBin;
-            
-            if (lowerBin >= 0 && upperBin <= bufferSize / 2) {
-                // Linear interpolation between bins
-                float lowerWeight = 1.0f - fraction;
-                float upperWeight = fraction;
-                
-                // Update magnitude using linear interpolation
-                float newMag = magnitude[i];
-                
-                // Update phase
-                float newPhaseDiff = phaseDiff[i];
-                
-                // Accumulate in output buffers
-                if (lowerBin > 0 && lowerBin < bufferSize / 2) {
-                    float phaseIncrement = newPhaseDiff * pitchShift;
-                    synthesisPhase[lowerBin] += phaseIncrement;
-                    
-                    // Convert back to rectangular form
-                    float mag = newMag * lowerWeight;
-                    float phase = synthesisPhase[lowerBin];
-                    fftBufferR[lowerBin] += mag * std::cos(phase);
-                    fftBufferI[lowerBin] += mag * std::sin(phase);
-                }
-                
-                if (upperBin > 0 && upperBin < bufferSize / 2) {
-                    float phaseIncrement = newPhaseDiff * pitchShift;
-                    synthesisPhase[upperBin] += phaseIncrement;
-                    
-                    // Convert back to rectangular form
-                    float mag = newMag * upperWeight;
-                    float phase = synthesisPhase[upperBin];
-                    fftBufferR[upperBin] += mag * std::cos(phase);
-                    fftBufferI[upperBin] += mag * std::sin(phase);
-                }
+        bool leftFree = left.collectJob();
+        if (!leftFree || !right.collectJob()) {
+            left.queueFrame();
+            right.queueFrame();
+            return;
+        }
+        right.jobHolder = &left;
+        if (left.frameQueued != right.frameQueued) {
+            // Only one side was queued (by a mono hop); keep the pair aligned
+            left.frameQueued = right.frameQueued = false;
+        }
+        left.loadJob();
+        right.loadJob();
+        left.jobShifts = left.currentShifts();
+        right.jobShifts = right.currentShifts();
+        left.jobPartner = &right;
+        left.jobStereoPlan = &plan;
+        left.jobState.store(JOB_POSTED, std::memory_order_release);
+        SpectralWorker::get().notify();
+    }
+
+    /**
+     * Keep this hop's analysis frame for the next job while the worker is
+     * busy; if one is already waiting, the newer frame replaces it
+     */
+    void queueFrame() {
+        readFrame(queuedFrame);
+        queuedDue = outputCount + hopSize;
+        frameQueued = true;
+    }
+
+    /**
+     * Fill the free job slot with the queued frame, if any, and this hop's
+     */
+    void loadJob() {
+        jobFrames = 0;
+        if (frameQueued) {
+            std::swap(queuedFrame, jobFrame[0]);
+            jobDue[0] = queuedDue;
+            jobFrames = 1;
+            frameQueued = false;
+        }
+        readFrame(jobFrame[jobFrames]);
+        jobDue[jobFrames] = outputCount + hopSize;
+        jobFrames++;
+    }
+
+    /**
+     * Synthesize the posted frames in order (and the stereo partner's, if any)
+     */
+    void runJob() {
+        for (int f = 0; f < jobFrames; f++) {
+            if (jobPartner) {
+                stereoSpectralFrame(*this, *jobPartner, *jobStereoPlan, jobFrame[f], jobPartner->jobFrame[f],
+                                    jobShifts, jobPartner->jobShifts);
+            }
+            else {
+                spectralFrame(jobFrame[f], jobShifts);
             }
         }
+    }
+
+    /**
+     * Extract the latest frame from the input buffer with analysis window
+     */
+    void readFrame(float* frame) {
+        int frameStart = (inputPos - bufferSize + ringSize) % ringSize;
+        for (int i = 0; i < bufferSize; i++) {
+            int bufIdx = (frameStart + i) % ringSize;
+            frame[i] = inputBuffer[bufIdx] * analysisWindow[i];
+        }
+    }
+
+    /**
+     * Apply synthesis window and overlap-add a frame to the output buffer
+     */
+    void overlapAdd(const float* frame) {
+        for (int i = 0; i < bufferSize; i++) {
+            int bufIdx = (outputPos + i) % ringSize;
+            outputBuffer[bufIdx] += frame[i] * synthesisWindow[i];
+        }
+    }
+
+    /**
+     * Rebuild every buffer for the current frame size (audio thread, with
+     * no job in flight)
+     */
+    void resetBuffers() {
+        arena.reserve(arenaFloats(MAX_FFT_SIZE));
+        fft.reserve(MAX_FFT_SIZE);
+        arena.rewind();
+        const int bins = bufferSize / 2 + 1;
         
-        // Zero out the negative frequencies (conjugate symmetric for real signals)
-        for (int i = bufferSize / 2 + 1; i < bufferSize; i++) {
-            fftBufferR[i] = fftBufferR[bufferSize - i];
-            fftBufferI[i] = -fftBufferI[bufferSize - i];
+        // Input and output buffers
+        ringSize = bufferSize * 2;
+        inputBuffer = arena.take(ringSize);
+        outputBuffer = arena.take(ringSize);
+        
+        // Initialize phase data
+        analysisPhase = arena.take(bins);
+        for (float*& voicePhase : synthesisPhase) {
+            voicePhase = arena.take(bins);
+        }
+        
+        // Reset counters
+        inputPos = 0;
+        outputPos = 0;
+        frameCount = 0;
+        bbdLowpass = 0.0f;
+        h910Highpass = 0.0f;
+        varisLowpass = 0.0f;
+        
+        // FFT data and transform tables; a real signal only needs the
+        // non-negative frequency bins
+        frameBuffer = arena.take(bufferSize);
+        for (float*& frame : jobFrame) {
+            frame = arena.take(bufferSize);
+        }
+        queuedFrame = arena.take(bufferSize);
+        jobFrames = 0;
+        frameQueued = false;
+        outputCount = 0;
+        fftBufferR = arena.take(bins);
+        fftBufferI = arena.take(bins);
+        fft.configure(bufferSize);
+        
+        // Per-frame spectral scratch
+        magnitude = arena.take(bins);
+        phase = arena.take(bins);
+        phaseDiff = arena.take(bins);
+        synthMagnitude = arena.take(bins);
+        synthPhaseAdvance = arena.take(bins);
+        peakBins.reserve(MAX_FFT_SIZE / 2 + 1);
+        
+        // Initialize windows
+        analysisWindow = arena.take(bufferSize);
+        synthesisWindow = arena.take(bufferSize);
+        
+        // Create Hann windows; at 2x overlap the squared Hann window does
+        // not sum to a constant, so analysis and synthesis use its square
+        // root (a sine window) and their product is Hann
+        for (int i = 0; i < bufferSize; i++) {
+            float windowValue = 0.5f - 0.5f * std::cos(2.0f * M_PI * i / bufferSize);
+            if (bufferSize / hopSize <= 2) {
+                windowValue = std::sqrt(windowValue);
+            }
+            analysisWindow[i] = windowValue;
+            synthesisWindow[i] = windowValue;
         }
         
-        // Perform inverse FFT
-        performFFT(fftBufferR, fftBufferI, bufferSize, true);
+        // Normalize windows for perfect reconstruction: the overlapping
+        // analysis * synthesis products must sum to one at every sample
+        float windowSum = 0.0f;
+        for (int i = 0; i < bufferSize; i += hopSize) {
+            windowSum += analysisWindow[i] * synthesisWindow[i];
+        }
         
-        // Apply synthesis window and overlap-add to output buffer
-        // Note: frameEnd variable was removed as it was unused
+        float windowScaleFactor = 1.0f / std::sqrt(windowSum);
         for (int i = 0; i < bufferSize; i++) {
-            int bufIdx = (outputPos + i) % outputBuffer.size();
-            float windowedSample = fftBufferR[i] * synthesisWindow[i];
-            outputBuffer[bufIdx] += windowedSample;
+            analysisWindow[i] *= windowScaleFactor;
+            synthesisWindow[i] *= windowScaleFactor;
         }
     }
 
     /**
-     * Simple FFT implementation
+     * Apply a reset, frame size or background change (audio thread)
      * 
-     * @param real Real part of the signal
-     * @param imag Imaginary part of the signal
-     * @param n FFT size
-     * @param inverse True for inverse FFT, false for forward FFT
+     * Waits for nothing: while the worker is synthesizing a frame from these
+     * buffers the change stays pending and is retried on the next block.
      */
-    void performFFT(std::vector<float>& real, std::vector<float>& imag, int n, bool inverse) {
-        // Bit reversal permutation
-        int bits = static_cast<int>(std::log2(n));
-        for (int i = 0; i < n; i++) {
-            int j = 0;
-            for (int k = 0; k < bits; k++) {
-                j = (j << 1) | ((i >> k) & 1);
+    void applyPendingChanges() {
+        if (resetPending) {
+            if (!jobHolder->releaseJob()) {
+                return;
             }
-            if (j > i) {
-                std::swap(real[i], real[j]);
-                std::swap(imag[i], imag[j]);
+            jobHolder = this;
+            bufferSize = requestedSize;
+            hopSize = requestedHop;
+            resetBuffers();
+            resetPending = false;
+        }
+        if (backgroundRequested != backgroundProcessing) {
+            if (!backgroundRequested && !collectJob()) {
+                return;
             }
+            frameQueued = false;
+            backgroundProcessing = backgroundRequested;
         }
-        
-        // Cooley-Tukey FFT algorithm
-        for (int step = 2; step <= n; step *= 2) {
-            float theta = 2.0f * M_PI / step * (inverse ? -1.0f : 1.0f);
-            for (int m = 0; m < n; m += step) {
-                for (int k = 0; k < step / 2; k++) {
-                    float thetaK = theta * k;
-                    float wR = std::cos(thetaK);
-                    float wI = std::sin(thetaK);
-                    
-                    int a = m + k;
-                    int b = m + k + step / 2;
-                    
-                    float aR = real[a];
-                    float aI = imag[a];
-                    float bR = real[b];
-                    float bI = imag[b];
-                    
-                    float tR = wR * bR - wI * bI;
-                    float tI = wR * bI + wI * bR;
-                    
-                    real[a] = aR + tR;
-                    imag[a] = aI + tI;
-                    real[b] = aR - tR;
-                    imag[b] = aI - tI;
-                }
+        changesPending = false;
+    }
+
+    /**
+     * Overlap-add the frames in flight, if any (audio thread)
+     * 
+     * Never waits. A job the worker has not started yet is synthesized
+     * here instead; a job the worker is still synthesizing stays with it
+     * and is collected at a later hop.
+     * 
+     * @return true if the slot is free for the next job
+     */
+    bool collectJob() {
+        int state = JOB_POSTED;
+        if (jobState.compare_exchange_strong(state, JOB_WORKING, std::memory_order_acquire)) {
+            runJob();
+            state = JOB_DONE;
+        }
+        if (state == JOB_EMPTY) {
+            return true;
+        }
+        if (state == JOB_WORKING) {
+            return false;
+        }
+        for (int f = 0; f < jobFrames; f++) {
+            overlapAddDue(jobFrame[f], jobDue[f]);
+            if (jobPartner) {
+                jobPartner->overlapAddDue(jobPartner->jobFrame[f], jobPartner->jobDue[f]);
             }
         }
+        jobState.store(JOB_EMPTY, std::memory_order_relaxed);
+        return true;
+    }
+
+    /**
+     * Overlap-add a synthesized frame where it was due to start
+     * 
+     * A late frame's start has already been read out, so only its rest is
+     * added, faded in over LATE_FADE samples from the cut.
+     * 
+     * @param frame Synthesized frame
+     * @param due outputCount at which the frame starts
+     */
+    void overlapAddDue(const float* frame, uint32_t due) {
+        int late = static_cast<int>(outputCount - due);
+        if (late <= 0) {
+            overlapAdd(frame);
+            return;
+        }
+        for (int i = late; i < bufferSize; i++) {
+            int bufIdx = (outputPos + i - late) % ringSize;
+            float fade = std::min(1.0f, static_cast<float>(i - late + 1) / LATE_FADE);
+            outputBuffer[bufIdx] += frame[i] * synthesisWindow[i] * fade;
+        }
+    }
+
+    /**
+     * Drop the frame in flight unless the worker is synthesizing it
+     * 
+     * @return true if the slot is free and the worker is done with the buffers
+     */
+    bool releaseJob() {
+        int state = JOB_POSTED;
+        if (!jobState.compare_exchange_strong(state, JOB_EMPTY, std::memory_order_acquire)
+            && state == JOB_WORKING) {
+            return false;
+        }
+        jobState.store(JOB_EMPTY, std::memory_order_relaxed);
+        jobFrames = 0;
+        frameQueued = false;
+        return true;
+    }
+
+    /**
+     * Phase vocoder analysis and synthesis of one windowed frame, in place
+     * 
+     * Runs on the audio thread or the SpectralWorker, never both at once.
+     * 
+     * @param frame Windowed input frame; replaced by the synthesized frame
+     * @param shifts Pitch ratio of each synthesis voice for this frame
+     */
+    void spectralFrame(float* frame, const ShiftSet& shifts) {
+        NoAllocScope noAlloc;
+        
+        // Perform forward FFT (real input: bins 0 .. N/2 only)
+        fft.forward(frame, fftBufferR, fftBufferI);
+        
+        shiftSpectrum(shifts);
+        
+        // Perform inverse FFT (the negative frequencies are implied by symmetry)
+        fft.inverse(fftBufferR, fftBufferI, frame);
+    }
+
+    /**
+     * spectralFrame() for a stereo pair, with one complex FFT each way
+     */
+    static void stereoSpectralFrame(PitchShifter& left, PitchShifter& right, StereoFFTPlan& plan,
+                                    float* frameL, float* frameR, const ShiftSet& shiftsL, const ShiftSet& shiftsR) {
+        NoAllocScope noAlloc;
+        
+        plan.forward(frameL, frameR, left.fftBufferR, left.fftBufferI, right.fftBufferR, right.fftBufferI);
+        left.shiftSpectrum(shiftsL);
+        right.shiftSpectrum(shiftsR);
+        plan.inverse(left.fftBufferR, left.fftBufferI, right.fftBufferR, right.fftBufferI, frameL, frameR);
+    }
+
+    /**
+     * Pitch shift the spectrum in fftBufferR/I in place
+     * 
+     * The analysis runs once; each synthesis voice then remaps the bins at
+     * its own ratio and the voices are summed into the output spectrum.
+     * 
+     * @param shifts Pitch ratio of each synthesis voice for this frame
+     */
+    void shiftSpectrum(const ShiftSet& shifts) {
+        // The polar conversions run four bins at a time; arena slices are
+        // padded to whole cache lines, so the last vector stays in its slice
+        const int bins = bufferSize / 2 + 1;
+        const int vectorBins = (bins + 3) & ~3;
+        
+        // Convert to polar coordinates and calculate the phase difference
+        // (instantaneous frequency) against the previous frame
+        const float binPhaseStep = 2.0f * float(M_PI) * hopSize / bufferSize;
+        for (int i = 0; i < vectorBins; i += 4) {
+            float_4 re = float_4::load(fftBufferR + i);
+            float_4 im = float_4::load(fftBufferI + i);
+            float_4 binPhase = simdAtan2(im, re);
+            simd::sqrt(re * re + im * im).store(magnitude + i);
+            
+            float_4 expectedPhase = binPhaseStep * (float_4(i) + float_4(0.0f, 1.0f, 2.0f, 3.0f));
+            float_4 phaseDelta = binPhase - float_4::load(analysisPhase + i);
+            (simdWrapPhase(phaseDelta - expectedPhase) + expectedPhase).store(phaseDiff + i);
+            
+            // Store current phase for next frame
+            binPhase.store(analysisPhase + i);
+        }
         
-        // Normalize if inverse FFT
-        if (inverse) {
-            for (int i = 0; i < n; i++) {
-                real[i] /= n;
-                imag[i] /= n;
+        std::fill(fftBufferR, fftBufferR + vectorBins, 0.0f);
+        std::fill(fftBufferI, fftBufferI + vectorBins, 0.0f);
+        const float voiceGain = 1.0f / std::sqrt(static_cast<float>(shifts.count));
+        if (shifts.phaseLocked) {
+            findPeaks(bins);
+        }
+        for (int v = 0; v < shifts.count; v++) {
+            if (shifts.phaseLocked) {
+                remapLocked(shifts.ratio[v], synthesisPhase[v], bins);
+            }
+            else {
+                remapBins(shifts.ratio[v], bins);
+            }
+            addVoice(synthesisPhase[v], voiceGain, vectorBins);
+        }
+    }
+
+    /**
+     * Collect the bins that are local maxima over two bins either side
+     */
+    void findPeaks(int bins) {
+        peakBins.clear();
+        for (int i = 0; i < bins; i++) {
+            float m = magnitude[i];
+            if (m <= 0.0f) {
+                continue;
+            }
+            if ((i >= 1 && magnitude[i - 1] >= m) || (i >= 2 && magnitude[i - 2] >= m) ||
+                (i + 1 < bins && magnitude[i + 1] > m) || (i + 2 < bins && magnitude[i + 2] > m)) {
+                continue;
+            }
+            peakBins.push_back(i);
+        }
+    }
+
+    /**
+     * Identity phase-locked remapping (Laroche and Dolson)
+     * 
+     * Each peak owns the bins up to halfway to its neighbouring peaks. The
+     * whole region moves by the integer bin offset that puts the peak at
+     * its shifted position; the peak's phase advances by its scaled
+     * instantaneous frequency, and every other bin in the region keeps its
+     * analysed phase offset from the peak. That keeps partials coherent at
+     * lower overlap than plain per-bin propagation.
+     * 
+     * Leaves the voice's magnitudes in synthMagnitude and, in
+     * synthPhaseAdvance, the step from its previous phases to the locked
+     * ones.
+     * 
+     * @param shift Pitch ratio of the voice
+     * @param voicePhase The voice's synthesis phases from the previous frame
+     * @param bins Number of bins
+     */
+    void remapLocked(float shift, const float* voicePhase, int bins) {
+        std::fill(synthMagnitude, synthMagnitude + bins, 0.0f);
+        std::fill(synthPhaseAdvance, synthPhaseAdvance + bins, 0.0f);
+        const int peakCount = static_cast<int>(peakBins.size());
+        for (int p = 0; p < peakCount; p++) {
+            int peak = peakBins[p];
+            int target = static_cast<int>(peak * shift + 0.5f);
+            if (target >= bins) {
+                break;
             }
+            int regionStart = (p == 0) ? 0 : (peakBins[p - 1] + peak + 1) / 2;
+            int regionEnd = (p == peakCount - 1) ? bins : (peak + peakBins[p + 1] + 1) / 2;
+            int offset = target - peak;
+            
+            // analysisPhase already holds this frame's phases
+            float peakPhase = voicePhase[target] + phaseDiff[peak] * shift;
+            float peakAnalysisPhase = analysisPhase[peak];
+            for (int i = std::max(regionStart, -offset); i < regionEnd && i + offset < bins; i++) {
+                int j = i + offset;
+                synthMagnitude[j] += magnitude[i];
+                float lockedPhase = peakPhase + (analysisPhase[i] - peakAnalysisPhase);
+                synthPhaseAdvance[j] = lockedPhase - voicePhase[j];
+            }
+        }
+    }
+
+    /**
+     * Per-bin remapping: leaves the voice's magnitudes in synthMagnitude and
+     * its phase advance per bin in synthPhaseAdvance
+     * 
+     * @param shift Pitch ratio of the voice
+     * @param bins Number of bins
+     */
+    void remapBins(float shift, int bins) {
+        // Move each analysis bin to its shifted position: the magnitude is
+        // split between the two nearest synthesis bins and the nearest one
+        // takes over the bin's phase advance, scaled by the shift
+        std::fill(synthMagnitude, synthMagnitude + bins, 0.0f);
+        std::fill(synthPhaseAdvance, synthPhaseAdvance + bins, 0.0f);
+        for (int i = 0; i < bins; i++) {
+            float newBinPos = i * shift;
+            int lowerBin = static_cast<int>(newBinPos);
+            if (lowerBin >= bins) {
+                break;
+            }
+            float fraction = newBinPos - lowerBin;
+            synthMagnitude[lowerBin] += magnitude[i] * (1.0f - fraction);
+            if (lowerBin + 1 < bins) {
+                synthMagnitude[lowerBin + 1] += magnitude[i] * fraction;
+            }
+            int nearestBin = (fraction < 0.5f) ? lowerBin : lowerBin + 1;
+            if (nearestBin < bins) {
+                synthPhaseAdvance[nearestBin] = phaseDiff[i] * shift;
+            }
+        }
+    }
+
+    /**
+     * Advance a voice's synthesis phases by synthPhaseAdvance and add it,
+     * scaled by gain, to fftBufferR/I in rectangular form
+     * 
+     * @param voicePhase The voice's running synthesis phases
+     * @param gain Output gain of the voice
+     * @param vectorBins Number of bins rounded up to a multiple of four
+     */
+    void addVoice(float* voicePhase, float gain, int vectorBins) {
+        for (int i = 0; i < vectorBins; i += 4) {
+            float_4 binPhase = float_4::load(voicePhase + i) + float_4::load(synthPhaseAdvance + i);
+            binPhase = simdWrapPhase(binPhase);   // Keep precision
+            binPhase.store(voicePhase + i);
+            float_4 sinPhase, cosPhase;
+            fastSinCos(binPhase, sinPhase, cosPhase);
+            float_4 mag = gain * float_4::load(synthMagnitude + i);
+            (float_4::load(fftBufferR + i) + mag * cosPhase).store(fftBufferR + i);
+            (float_4::load(fftBufferI + i) + mag * sinPhase).store(fftBufferI + i);
         }
     }
 
@@ -410,30 +1087,30 @@ private:
         switch (pitchMode) {
             case 0: // BBD (Bucket Brigade Device)
                 // Add subtle sample-and-hold artifacts and clock noise
-                processed += (std::sin(frameCount * 0.1f) * 0.001f) * characterAmount;
+                processed += (fastSin(frameCount * 0.1f) * 0.001f) * characterAmount;
                 processed = processed * (1.0f - characterAmount * 0.1f) + 
-                           std::tanh(processed * 1.5f) * characterAmount * 0.1f;
+                           fastTanh(processed * 1.5f) * characterAmount * 0.1f;
                 break;
                 
             case 1: // H910 Harmonizer
                 // Add subtle digital quantization and aliasing
                 if (characterAmount > 0.5f) {
                     float bits = 16.0f - characterAmount * 4.0f; // Reduce bit depth
-                    float scale = std::pow(2.0f, bits - 1.0f);
+                    float scale = fastExp2(bits - 1.0f);
                     processed = std::round(processed * scale) / scale;
                 }
                 break;
                 
             case 2: // Varispeed
                 // Add tape-like saturation and wow
-                processed = std::tanh(processed * (1.0f + characterAmount)) / (1.0f + characterAmount);
-                processed += std::sin(frameCount * 0.01f) * characterAmount * 0.005f;
+                processed = fastTanh(processed * (1.0f + characterAmount)) / (1.0f + characterAmount);
+                processed += fastSin(frameCount * 0.01f) * characterAmount * 0.005f;
                 break;
                 
             case 3: // Hybrid
                 // Combine elements from all modes
-                processed = std::tanh(processed * (1.0f + characterAmount * 0.3f)) / (1.0f + characterAmount * 0.3f);
-                processed += (std::sin(frameCount * 0.05f) * 0.002f) * characterAmount;
+                processed = fastTanh(processed * (1.0f + characterAmount * 0.3f)) / (1.0f + characterAmount * 0.3f);
+                processed += (fastSin(frameCount * 0.05f) * 0.002f) * characterAmount;
                 break;
         }
         
@@ -456,7 +1133,6 @@ private:
         switch (pitchMode) {
             case 0: { // BBD
                 // Add subtle low-pass filtering
-                static float bbdLowpass = 0.0f;
                 float cutoff = 1.0f - characterAmount * 0.3f;
                 bbdLowpass += (processed - bbdLowpass) * cutoff;
                 processed = bbdLowpass;
@@ -465,7 +1141,6 @@ private:
                 
             case 1: { // H910
                 // Add slight high-frequency emphasis
-                static float h910Highpass = 0.0f;
                 h910Highpass += (processed - h910Highpass) * 0.95f;
                 processed += (processed - h910Highpass) * characterAmount * 0.1f;
                 break;
@@ -473,7 +1148,6 @@ private:
                 
             case 2: { // Varispeed
                 // Add subtle filtering and warmth
-                static float varisLowpass = 0.0f;
                 varisLowpass += (processed - varisLowpass) * 0.8f;
                 processed = processed * (1.0f - characterAmount * 0.3f) + varisLowpass * characterAmount * 0.3f;
                 break;
@@ -481,7 +1155,7 @@ private:
                 
             case 3: { // Hybrid
                 // Gentle overall processing
-                processed = std::tanh(processed * 0.9f) * 1.1f;
+                processed = fastTanh(processed * 0.9f) * 1.1f;
                 break;
             }
         }
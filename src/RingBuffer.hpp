@@ -0,0 +1,208 @@
+#pragma once
+#include <algorithm>
+#include <atomic>
+#include <vector>
+
+namespace CurveAndDrag {
+
+/**
+ * TRingBuffer - Power-of-two circular buffer with a mirrored guard region
+ *
+ * Capacity is rounded up to a power of two so positions wrap with a mask
+ * instead of a division. The first GUARD samples are mirrored past the end,
+ * so a kernel starting at any wrapped index can read GUARD + 1 contiguous
+ * samples without checking for wrap. T is float or float_4.
+ *
+ * Storage can be built on another thread with prepare() and handed to the
+ * audio thread with publish(); the storage it replaces is pushed onto a
+ * lock-free retired list and freed by the next collect(), so the audio
+ * thread never allocates, frees or waits for a collection; it checks
+ * hasRetired() to know when to ask for one.
+ *
+ * @tparam GUARD Number of mirrored samples past the end
+ */
+template <typename T, int GUARD = 4>
+class TRingBuffer {
+public:
+    static constexpr int GUARD_SIZE = GUARD;
+
+    TRingBuffer() {}
+    TRingBuffer(const TRingBuffer&) = delete;
+    TRingBuffer& operator=(const TRingBuffer&) = delete;
+
+    ~TRingBuffer() {
+        delete storage;
+        delete pending.load();
+        collect();
+    }
+
+    /**
+     * Allocate and clear storage for at least minCapacity samples now
+     *
+     * Only for use when the audio thread is not running this buffer.
+     *
+     * @param minCapacity Required number of samples
+     */
+    void resize(int minCapacity) {
+        delete storage;
+        storage = build(minCapacity);
+        attach();
+    }
+
+    /**
+     * Build cleared storage for at least minCapacity samples and queue it
+     * for publish() (any thread but the audio thread)
+     *
+     * @param minCapacity Required number of samples
+     */
+    void prepare(int minCapacity) {
+        collect();
+        delete pending.exchange(build(minCapacity), std::memory_order_acq_rel);
+    }
+
+    /**
+     * Free storage retired by publish() (any thread but the audio thread)
+     */
+    void collect() {
+        Storage* s = retired.exchange(nullptr, std::memory_order_acq_rel);
+        while (s) {
+            Storage* next = s->nextRetired;
+            delete s;
+            s = next;
+        }
+    }
+
+    /**
+     * @return true if publish() has retired storage that collect() has not
+     *         freed yet
+     */
+    bool hasRetired() const {
+        return retired.load(std::memory_order_relaxed) != nullptr;
+    }
+
+    /**
+     * @return true if prepared storage is waiting to be published
+     */
+    bool hasPending() const {
+        return pending.load(std::memory_order_acquire) != nullptr;
+    }
+
+    /**
+     * Switch to prepared storage (audio thread); the old storage is retired
+     *
+     * Never waits: retired storage queues up until collect() frees it.
+     *
+     * @return true if the storage changed; false if nothing was pending
+     */
+    bool publish() {
+        if (!hasPending()) {
+            return false;
+        }
+        Storage* next = pending.exchange(nullptr, std::memory_order_acq_rel);
+        if (!next) {
+            return false;
+        }
+        if (storage) {
+            // Push onto the retired list; collect() only ever takes the whole list
+            storage->nextRetired = retired.load(std::memory_order_relaxed);
+            while (!retired.compare_exchange_weak(storage->nextRetired, storage,
+                                                  std::memory_order_release, std::memory_order_relaxed)) {
+            }
+        }
+        storage = next;
+        attach();
+        return true;
+    }
+
+    /**
+     * Zero the contents, keeping the current capacity
+     */
+    void clear() {
+        if (storage) {
+            std::fill(storage->samples.begin(), storage->samples.end(), T(0.0f));
+        }
+    }
+
+    /**
+     * Write a sample, mirroring it into the guard region if needed
+     *
+     * @param index Wrapped position in [0, capacity)
+     * @param sample Sample to store
+     */
+    void write(int index, T sample) {
+        samples[index] = sample;
+        if (index < GUARD) {
+            samples[size + index] = sample;
+        }
+    }
+
+    /**
+     * Read a sample at any position, wrapping it first
+     */
+    T read(int index) const {
+        return samples[index & mask];
+    }
+
+    /**
+     * Wrap a position into [0, capacity)
+     */
+    int wrap(int index) const {
+        return index & mask;
+    }
+
+    /**
+     * Raw storage; data()[i] to data()[i + GUARD] are valid for any
+     * wrapped index i
+     */
+    const T* data() const {
+        return samples;
+    }
+
+    int capacity() const {
+        return size;
+    }
+
+    int getMask() const {
+        return mask;
+    }
+
+    bool empty() const {
+        return size == 0;
+    }
+
+private:
+    struct Storage {
+        std::vector<T> samples;
+        int size;
+        Storage* nextRetired = nullptr;
+    };
+
+    // Owned by the audio thread
+    Storage* storage = nullptr;
+    T* samples = nullptr;
+    int size = 0;
+    int mask = 0;
+
+    // Hand-off between the allocating thread and the audio thread
+    std::atomic<Storage*> pending{nullptr};
+    std::atomic<Storage*> retired{nullptr};
+
+    static Storage* build(int minCapacity) {
+        int capacity = 1;
+        while (capacity < minCapacity) {
+            capacity <<= 1;
+        }
+        Storage* s = new Storage;
+        s->samples.assign(capacity + GUARD, T(0.0f));
+        s->size = capacity;
+        return s;
+    }
+
+    void attach() {
+        samples = storage ? storage->samples.data() : nullptr;
+        size = storage ? storage->size : 0;
+        mask = size ? size - 1 : 0;
+    }
+};
+
+} // namespace CurveAndDrag
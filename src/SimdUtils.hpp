@@ -0,0 +1,110 @@
+#pragma once
+#include <rack.hpp>
+#include <cmath>
+
+namespace CurveAndDrag {
+
+namespace simd = rack::simd;
+using simd::float_4;
+using simd::int32_4;
+
+/**
+ * Helpers shared by the scalar (float) and polyphonic (float_4) DSP paths
+ *
+ * Each function has a float and a float_4 overload so templated processors
+ * can be written once for both sample types.
+ */
+
+/**
+ * Replace NaN/infinite values with a fallback, lane by lane
+ *
+ * @param x Value to check
+ * @param fallback Value used where x is not finite
+ * @return x where finite, otherwise fallback
+ */
+inline float replaceNonFinite(float x, float fallback) {
+    return std::isfinite(x) ? x : fallback;
+}
+
+inline float_4 replaceNonFinite(float_4 x, float_4 fallback) {
+    // NaN fails every comparison, so it takes the fallback too
+    return simd::ifelse(simd::abs(x) < INFINITY, x, fallback);
+}
+
+/**
+ * Read a power-of-two ring buffer at a per-lane position
+ *
+ * Lane k reads buf[(int(pos[k]) + offset) & mask][k], so every voice in a
+ * group can read its own position from a buffer of whole groups.
+ *
+ * @param buf Ring buffer
+ * @param pos Read position, truncated toward zero
+ * @param offset Integer offset added after truncation
+ * @param mask Buffer size minus one
+ * @return Sample read for each lane
+ */
+inline float readLanes(const float* buf, float pos, int offset, int mask) {
+    return buf[(static_cast<int>(pos) + offset) & mask];
+}
+
+inline float_4 readLanes(const float_4* buf, float_4 pos, int offset, int mask) {
+    float_4 out;
+    for (int k = 0; k < 4; k++) {
+        out[k] = buf[(static_cast<int>(pos[k]) + offset) & mask][k];
+    }
+    return out;
+}
+
+/**
+ * Dot product of two float arrays, four products at a time
+ *
+ * @param a First array (any alignment)
+ * @param b Second array (any alignment)
+ * @param n Number of elements, a multiple of four
+ */
+inline float simdDot(const float* a, const float* b, int n) {
+    float_4 sum = 0.0f;
+    for (int i = 0; i < n; i += 4) {
+        sum += float_4::load(a + i) * float_4::load(b + i);
+    }
+    return sum[0] + sum[1] + sum[2] + sum[3];
+}
+
+/**
+ * Wrap a phase into [-pi, pi)
+ */
+inline float simdWrapPhase(float x) {
+    const float twoPi = 2.0f * float(M_PI);
+    return x - twoPi * std::floor(x * (1.0f / twoPi) + 0.5f);
+}
+
+inline float_4 simdWrapPhase(float_4 x) {
+    const float twoPi = 2.0f * float(M_PI);
+    return x - twoPi * simd::floor(x * (1.0f / twoPi) + 0.5f);
+}
+
+/**
+ * Four-quadrant arctangent
+ *
+ * The float_4 version uses a degree-11 odd polynomial on [0, 1] after
+ * octant reduction; absolute error is below 3e-6 rad. atan2(0, 0) is 0.
+ */
+inline float simdAtan2(float y, float x) {
+    return std::atan2(y, x);
+}
+
+inline float_4 simdAtan2(float_4 y, float_4 x) {
+    float_4 ax = simd::abs(x);
+    float_4 ay = simd::abs(y);
+    float_4 hi = simd::fmax(ax, ay);
+    float_4 lo = simd::fmin(ax, ay);
+    float_4 a = simd::ifelse(hi > 0.0f, lo / hi, 0.0f);
+    float_4 s = a * a;
+    float_4 r = a * (0.99997726f + s * (-0.33262347f + s * (0.19354346f +
+                s * (-0.11643287f + s * (0.05265332f + s * -0.01172120f)))));
+    r = simd::ifelse(ay > ax, float(M_PI / 2) - r, r);
+    r = simd::ifelse(x < 0.0f, float(M_PI) - r, r);
+    return simd::ifelse(y < 0.0f, -r, r);
+}
+
+} // namespace CurveAndDrag
@@ -0,0 +1,151 @@
+#pragma once
+#include <algorithm>
+#include <atomic>
+#include <condition_variable>
+#include <mutex>
+#include <thread>
+#include <vector>
+#include "WakeSemaphore.hpp"
+
+namespace CurveAndDrag {
+
+/**
+ * SpectralJobClient - Owner of spectral frames the worker can run
+ *
+ * The audio thread posts a frame into the client's job slot and calls
+ * SpectralWorker::notify(); the worker then calls runPostedJob() on every
+ * client, which runs the frame only if one is posted and not yet claimed.
+ */
+struct SpectralJobClient {
+    virtual ~SpectralJobClient() {}
+
+    /**
+     * Run the posted frame, if any (worker thread)
+     */
+    virtual void runPostedJob() = 0;
+};
+
+/**
+ * SpectralWorker - Plugin-wide thread that runs phase vocoder frames
+ *
+ * Moves the FFT work of every attached vocoder off the engine thread. The
+ * engine thread never takes the lock and never waits: notify() sets a flag,
+ * and posts the semaphore only if the worker has gone to sleep, so while
+ * the worker is busy a notify is two atomic operations. The worker sleeps
+ * on the semaphore with no timeout and runs jobs with the lock released.
+ *
+ * The thread runs only while clients are attached: the first attach()
+ * starts it and the last detach() stops and joins it. The instance itself
+ * is never destroyed, so nothing is joined from a static destructor while
+ * the plugin library unloads.
+ */
+class SpectralWorker {
+public:
+    static SpectralWorker& get() {
+        static SpectralWorker* worker = new SpectralWorker;
+        return *worker;
+    }
+
+    /**
+     * Register a client, starting the thread for the first one (any thread
+     * but the audio thread)
+     */
+    void attach(SpectralJobClient* client) {
+        std::lock_guard<std::mutex> lifetime(lifetimeMutex);
+        {
+            std::lock_guard<std::mutex> lock(mutex);
+            clients.push_back(client);
+        }
+        if (!thread.joinable()) {
+            running.store(true, std::memory_order_seq_cst);
+            thread = std::thread([this]() { run(); });
+        }
+    }
+
+    /**
+     * Unregister a client; waits for a pass already running on it to
+     * finish, and stops and joins the thread after the last client
+     */
+    void detach(SpectralJobClient* client) {
+        std::lock_guard<std::mutex> lifetime(lifetimeMutex);
+        bool last;
+        {
+            std::unique_lock<std::mutex> lock(mutex);
+            clients.erase(std::remove(clients.begin(), clients.end(), client), clients.end());
+            served.wait(lock, [this, client]() { return serving != client; });
+            last = clients.empty();
+        }
+        if (last && thread.joinable()) {
+            running.store(false, std::memory_order_seq_cst);
+            notify();
+            thread.join();
+        }
+    }
+
+    /**
+     * Wake the worker after posting a job; safe on the audio thread
+     */
+    void notify() {
+        posted.store(true, std::memory_order_seq_cst);
+        if (sleeping.exchange(false, std::memory_order_seq_cst)) {
+            wake.post();
+        }
+    }
+
+private:
+    std::mutex lifetimeMutex;   // Serializes starting and stopping the thread
+    std::mutex mutex;
+    std::condition_variable served;
+    std::vector<SpectralJobClient*> clients;
+    SpectralJobClient* serving = nullptr;  // Client being served outside the lock
+    std::thread thread;
+    WakeSemaphore wake;
+    std::atomic<bool> posted{false};
+    std::atomic<bool> sleeping{false};
+    std::atomic<bool> running{false};
+
+    SpectralWorker() {}
+
+    /**
+     * Sleep until notify() has been called since the last pass
+     *
+     * Announces the sleep before checking for work, so a notify() either
+     * sees the flag and posts, or its job is found by the check.
+     */
+    void waitForJobs() {
+        if (posted.exchange(false, std::memory_order_seq_cst)) {
+            return;
+        }
+        sleeping.store(true, std::memory_order_seq_cst);
+        if (posted.exchange(false, std::memory_order_seq_cst)) {
+            // A notify() that already took the flag back has posted, or is
+            // about to; consume it so the next sleep does not return early
+            if (!sleeping.exchange(false, std::memory_order_seq_cst)) {
+                wake.wait();
+            }
+            return;
+        }
+        wake.wait();
+    }
+
+    void run() {
+        while (running.load(std::memory_order_seq_cst)) {
+            waitForJobs();
+            // Jobs run with the lock released, as in BackgroundAllocator, so
+            // attach() and detach() of other voices never wait on a frame;
+            // detach() of the client being served waits for it instead.
+            std::unique_lock<std::mutex> lock(mutex);
+            for (size_t i = 0; i < clients.size(); i++) {
+                SpectralJobClient* client = clients[i];
+                serving = client;
+                lock.unlock();
+                client->runPostedJob();
+                lock.lock();
+                serving = nullptr;
+                served.notify_all();
+            }
+        }
+    }
+};
+
+} // namespace CurveAndDrag
@@ -0,0 +1,169 @@
+#pragma once
+#include <rack.hpp>
+#include <array>
+#include <cmath>
+#include "SimdUtils.hpp"
+
+namespace CurveAndDrag {
+
+/**
+ * SpliceSearch - SOLA splice point search for granular pitch shifters
+ *
+ * When a grain restarts, the delay it restarts at is pushed back by the
+ * offset whose waveform lines up best with the grain it crossfades into.
+ * Candidates are compared by normalized cross-correlation on a box-filtered
+ * buffer decimated by DECIMATION, with the SIMD simdDot() kernel, and the
+ * winner is refined at full rate. Offsets only need to span one period of
+ * the input, so the period is estimated from the reference's
+ * autocorrelation and cached for REFRESH splices.
+ *
+ * A search reads at most SPAN samples behind the later of its two
+ * positions. Works on one lane of a float_4 ring buffer; each lane keeps
+ * its own period estimate.
+ */
+class SpliceSearch {
+public:
+    static constexpr int DECIMATION = 4;
+    static constexpr int LENGTH = 32;           // Decimated points compared
+    static constexpr int MIN_PERIOD = 32;       // Samples
+    static constexpr int MAX_PERIOD = 512;      // Samples (86 Hz at 44.1 kHz)
+    static constexpr int REFRESH = 8;           // Splices per period estimate
+    static constexpr int SPAN = (LENGTH + MAX_PERIOD / DECIMATION) * DECIMATION + DECIMATION;
+
+    /**
+     * Find the extra delay for a grain restarting at newPos
+     *
+     * @param buf Ring buffer of four lanes
+     * @param mask Buffer size minus one
+     * @param lane Lane to search
+     * @param refPos Read position of the grain being crossfaded into
+     * @param newPos Read position the new grain would start at
+     * @return Extra delay in samples, at most MAX_PERIOD + DECIMATION
+     */
+    float findOffset(const float_4* buf, int mask, int lane, float refPos, float newPos) {
+        const int maxLag = MAX_PERIOD / DECIMATION;
+        int ref = static_cast<int>(refPos);
+        int start = static_cast<int>(newPos);
+
+        // Refresh the cached period from the reference's autocorrelation
+        if (age[lane] <= 0) {
+            gather(reference.data(), LENGTH + maxLag, buf, mask, lane, ref);
+            period[lane] = estimatePeriod();
+            age[lane] = REFRESH;
+        } else {
+            gather(reference.data(), LENGTH, buf, mask, lane, ref);
+        }
+        age[lane]--;
+
+        // Coarse search over one period of decimated offsets
+        int lags = std::min(maxLag, period[lane] / DECIMATION + 1);
+        gather(candidate.data(), LENGTH + lags, buf, mask, lane, start);
+        int best = bestLag(candidate.data(), 0, lags);
+
+        // Refine at full rate around the winner
+        int bestOffset = best * DECIMATION;
+        float bestScore = -INFINITY;
+        for (int offset = std::max(0, bestOffset - DECIMATION + 1); offset < bestOffset + DECIMATION; offset++) {
+            float cross = 0.0f;
+            float energy = 1e-9f;
+            for (int j = 0; j < LENGTH; j++) {
+                float a = buf[(ref - j * DECIMATION) & mask][lane];
+                float b = buf[(start - offset - j * DECIMATION) & mask][lane];
+                cross += a * b;
+                energy += b * b;
+            }
+            float score = cross / std::sqrt(energy);
+            if (score > bestScore) {
+                bestScore = score;
+                bestOffset = offset;
+            }
+        }
+        return static_cast<float>(bestOffset);
+    }
+
+    void reset() {
+        period.fill(MAX_PERIOD);
+        age.fill(0);
+    }
+
+private:
+    static constexpr int SCRATCH = LENGTH + MAX_PERIOD / DECIMATION + 4;
+
+    alignas(16) std::array<float, SCRATCH> reference = {};
+    alignas(16) std::array<float, SCRATCH> candidate = {};
+    std::array<int, 4> period = {MAX_PERIOD, MAX_PERIOD, MAX_PERIOD, MAX_PERIOD};
+    std::array<int, 4> age = {};
+
+    /**
+     * Box-filter and decimate count points backwards from pos into out
+     */
+    static void gather(float* out, int count, const float_4* buf, int mask, int lane, int pos) {
+        for (int j = 0; j < count; j++) {
+            int end = pos - j * DECIMATION;
+            float sum = 0.0f;
+            for (int i = 0; i < DECIMATION; i++) {
+                sum += buf[(end - i) & mask][lane];
+            }
+            out[j] = sum * (1.0f / DECIMATION);
+        }
+    }
+
+    /**
+     * Lag in [first, first + count) whose segment of x best matches reference
+     */
+    int bestLag(const float* x, int first, int count) const {
+        // Running energy of the LENGTH-point window starting at each lag
+        float energy = 1e-9f;
+        for (int j = 0; j < LENGTH; j++) {
+            energy += x[first + j] * x[first + j];
+        }
+        int best = first;
+        float bestScore = -INFINITY;
+        for (int lag = first; lag < first + count; lag++) {
+            float score = simdDot(reference.data(), x + lag, LENGTH) / std::sqrt(energy);
+            if (score > bestScore) {
+                bestScore = score;
+                best = lag;
+            }
+            energy += x[lag + LENGTH] * x[lag + LENGTH] - x[lag] * x[lag];
+            energy = std::max(energy, 1e-9f);
+        }
+        return best;
+    }
+
+    /**
+     * Period of the gathered reference from its autocorrelation, in samples
+     *
+     * Takes the shortest lag scoring within 10% of the best, so a multiple
+     * of the period does not win; aperiodic input gives MAX_PERIOD.
+     */
+    int estimatePeriod() const {
+        const int minLag = MIN_PERIOD / DECIMATION;
+        const int maxLag = MAX_PERIOD / DECIMATION;
+        float scores[MAX_PERIOD / DECIMATION + 1];
+        float energy = 1e-9f;
+        float referenceEnergy = 1e-9f;
+        for (int j = 0; j < LENGTH; j++) {
+            referenceEnergy += reference[j] * reference[j];
+            energy += reference[minLag + j] * reference[minLag + j];
+        }
+        float bestScore = -INFINITY;
+        for (int lag = minLag; lag <= maxLag; lag++) {
+            scores[lag] = simdDot(reference.data(), reference.data() + lag, LENGTH) / std::sqrt(energy * referenceEnergy);
+            bestScore = std::max(bestScore, scores[lag]);
+            energy += reference[lag + LENGTH] * reference[lag + LENGTH] - reference[lag] * reference[lag];
+            energy = std::max(energy, 1e-9f);
+        }
+        if (bestScore < 0.5f) {
+            return MAX_PERIOD;
+        }
+        for (int lag = minLag; lag <= maxLag; lag++) {
+            if (scores[lag] >= 0.9f * bestScore) {
+                return lag * DECIMATION;
+            }
+        }
+        return MAX_PERIOD;
+    }
+};
+
+} // namespace CurveAndDrag
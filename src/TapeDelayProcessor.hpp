@@ -2,9 +2,16 @@
 #include <rack.hpp>
 #include <vector>
 #include <array>
+#include <algorithm>
 #include <atomic>
 #include <cmath>
 #include <random>
+#include "CachedBiquad.hpp"
+#include "FastMath.hpp"
+#include "LinearRamp.hpp"
+#include "Oversampler.hpp"
+#include "RingBuffer.hpp"
+#include "SimdUtils.hpp"
 
 namespace CurveAndDrag {
 
@@ -21,78 +28,163 @@ enum WowFlutterWaveform {
 };
 
 /**
- * Tape head structure for multi-head delay system
+ * Tape engine states; the engine only runs outside TAPE_OFF
  */
-struct TapeHead {
-    std::vector<float> buffer;
+enum TapeState {
+    TAPE_OFF,
+    TAPE_FADING_IN,
+    TAPE_ON,
+    TAPE_FADING_OUT
+};
+
+/**
+ * Tape loop for one channel of the multi-head delay system
+ * 
+ * A single ring buffer is written by the record head and read by up to
+ * NUM_TAPS play heads at fractional positions. Tap positions are computed
+ * together in one float_4 pass, one play head per lane. T is float, or
+ * float_4 to hold four poly voices per tape position.
+ * 
+ * The tape is built by prepare() on a background thread and threaded at
+ * the next update(); the heads stay silent until then and fade across a
+ * later tape change. reset() does not erase the tape: a head stays silent
+ * until the record head has laid down fresh tape as far back as it reads.
+ */
+template <typename T>
+struct TTapeLoop {
+    static constexpr int NUM_TAPS = 4;
+    
+    static constexpr int FADE_SAMPLES = 256;
+    
+    TRingBuffer<T, 2> buffer;
     int writePos = 0;
-    int readPos = 0;
-    float delayTime = 0.0f;
+    int recorded = 0;                  // Samples written since the last reset
     float sampleRate = 44100.0f;
+    float preparedSampleRate = 0.0f;   // Background thread only
+    TLinearRamp<float> fade;
     
-    void configure(float sr, float maxDelayMs = 2000.0f) {
+    void configure(float sr) {
         sampleRate = sr;
-        int bufferSize = static_cast<int>(maxDelayMs * sr / 1000.0f) + 1;
-        buffer.resize(bufferSize, 0.0f);
+    }
+    
+    void reset() {
         writePos = 0;
-        readPos = 0;
+        recorded = 0;
     }
     
-    void writeToTape(float sample) {
-        buffer[writePos] = sample;
-        writePos = (writePos + 1) % buffer.size();
+    /**
+     * Build a tape long enough for maxDelayMs (background thread only)
+     */
+    void prepare(float sr, float maxDelayMs = 2000.0f) {
+        if (sr == preparedSampleRate) {
+            buffer.collect();
+            return;
+        }
+        int bufferSize = static_cast<int>(maxDelayMs * sr / 1000.0f) + 1;
+        buffer.prepare(bufferSize);
+        preparedSampleRate = sr;
     }
     
-    float readFromTape(float modulation = 1.0f) {
-        // CRITICAL FIX: Ensure buffer is not empty and delay time is set
-        if (buffer.empty() || delayTime <= 0.0f) {
-            return 0.0f;
+    /**
+     * Thread a prepared tape at a block boundary, fading the heads out
+     * first if the old tape is playing
+     * 
+     * @param n Number of samples in the coming block
+     */
+    void update(int n) {
+        float target = 1.0f;
+        if (buffer.hasPending()) {
+            target = 0.0f;
+            if ((buffer.empty() || fade.value <= 0.0f) && buffer.publish()) {
+                writePos = 0;
+                recorded = 0;
+                target = 1.0f;
+            }
         }
-        
-        // ===== CRITICAL FIX: Apply modulation directly to delay time =====
-        // This ensures wow and flutter actually modulate the delay time
-        float modulatedDelayTime = delayTime * modulation; // Apply modulation to delay time
-        
-        // Calculate read position with modulated delay time
-        float delayInSamples = modulatedDelayTime * sampleRate / 1000.0f;
-        int delaySamples = static_cast<int>(delayInSamples);
-        float fraction = delayInSamples - delaySamples;
-        
-        // CRITICAL FIX: Ensure we don't read beyond buffer boundaries
-        delaySamples = clamp(delaySamples, 1, static_cast<int>(buffer.size()) - 2);
-        
-        // Calculate read positions with bounds checking
-        int pos1 = (writePos - delaySamples - 1 + buffer.size()) % buffer.size();
-        int pos2 = (writePos - delaySamples + buffer.size()) % buffer.size();
-        
-        // CRITICAL FIX: Ensure positions are valid
-        pos1 = clamp(pos1, 0, static_cast<int>(buffer.size()) - 1);
-        pos2 = clamp(pos2, 0, static_cast<int>(buffer.size()) - 1);
-        
-        // Linear interpolation for smooth delay modulation
-        float sample1 = buffer[pos1];
-        float sample2 = buffer[pos2];
-        
-        return sample1 * (1.0f - fraction) + sample2 * fraction;
+        float maxStep = static_cast<float>(n) / FADE_SAMPLES;
+        fade.setTarget(fade.value + std::max(-maxStep, std::min(target - fade.value, maxStep)), n);
+    }
+    
+    void writeToTape(T sample) {
+        if (buffer.empty()) {
+            return;
+        }
+        buffer.write(writePos, sample);
+        writePos = buffer.wrap(writePos + 1);
+        recorded = std::min(recorded + 1, buffer.capacity());
+    }
+    
+    /**
+     * Read every play head from the tape
+     * 
+     * @param delayMs Delay time of each head in ms (0 = head disabled)
+     * @param modulation Delay time scale of each head (wow/flutter and head speed)
+     * @param out Output of each head
+     */
+    void readTaps(float_4 delayMs, float_4 modulation, T* out) {
+        if (buffer.empty()) {
+            std::fill(out, out + NUM_TAPS, T(0.0f));
+            fade.reset(0.0f);
+            return;
+        }
+        float gain = fade.next();
+        
+        // Positions for all heads at once; the most recent sample is 0 samples old
+        float_4 delaySamples = delayMs * modulation * (sampleRate / 1000.0f);
+        delaySamples = simd::clamp(delaySamples, 1.0f, static_cast<float>(buffer.capacity() - 3));
+        float_4 whole = simd::floor(delaySamples);
+        float_4 fraction = delaySamples - whole;
+        
+        // Disabled heads, and heads still behind the last reset, are
+        // silenced by their gain instead of a branch
+        float_4 live = (delayMs > 0.0f) & (whole + 2.0f <= float_4(static_cast<float>(recorded)));
+        float_4 headGain = simd::ifelse(live, float_4(gain), float_4(0.0f));
+        
+        // Each head reads two neighbouring samples; the guard covers the wrap
+        int32_4 older = (int32_4(writePos) - int32_4(whole) - 2) & int32_4(buffer.getMask());
+        interpolateHeads(buffer.data(), older, fraction, headGain, out);
+    }
+    
+private:
+    static_assert(NUM_TAPS == 4, "play heads are the lanes of a float_4");
+    
+    /**
+     * Mono tape: one head per lane, so all heads interpolate in one pass
+     */
+    static void interpolateHeads(const float* tape, int32_4 older, float_4 fraction, float_4 gain, float* out) {
+        float_4 olderSample(tape[older[0]], tape[older[1]], tape[older[2]], tape[older[3]]);
+        float_4 newerSample(tape[older[0] + 1], tape[older[1] + 1], tape[older[2] + 1], tape[older[3] + 1]);
+        float_4 y = (newerSample + fraction * (olderSample - newerSample)) * gain;
+        y.store(out);
     }
     
-    void setDelayTime(float timeMs) {
-        delayTime = clamp(timeMs, 1.0f, 2000.0f);
+    /**
+     * Poly tape: a head's voices fill one float_4, weighted by its lane of
+     * the head vectors
+     */
+    static void interpolateHeads(const float_4* tape, int32_4 older, float_4 fraction, float_4 gain, float_4* out) {
+        for (int head = 0; head < NUM_TAPS; head++) {
+            float_4 newerSample = tape[older[head] + 1];
+            out[head] = (newerSample + fraction[head] * (tape[older[head]] - newerSample)) * gain[head];
+        }
     }
 };
 
 /**
- * TapeDelayProcessor - Emulation of tape delay characteristics
+ * TTapeDelayProcessor - Emulation of tape delay characteristics
  * 
  * Provides wow & flutter, tape saturation, head bump EQ, and tape noise
- * to enhance the delay lines with vintage tape character
+ * to enhance the delay lines with vintage tape character. T is float, or
+ * float_4 to process four poly voices per SIMD lane; the transport (wow,
+ * flutter, instability, noise) is shared by the voices of one processor.
  */
-class TapeDelayProcessor {
+template <typename T = float>
+class TTapeDelayProcessor {
 public:
-    TapeDelayProcessor() {
+    TTapeDelayProcessor() {
         // Initialize with default values
         sampleRate = 44100.f;
-        tapeModeEnabled = false;
+        tapeState = TAPE_OFF;
         
         // Wow & Flutter
         wowRate = 0.3f;
@@ -124,6 +216,7 @@ public:
         agingAmount = 0.0f;
         instabilityAmount = 0.0f;
         headConfiguration = 0;
+        updateHeadTimes();
         
         // Initialize filters
         initializeFilters();
@@ -140,18 +233,42 @@ public:
             sampleRate = newSampleRate;
             initializeFilters();
             
-            // Configure tape heads
+            // Tape loops are rebuilt off-thread by prepareTape()
             for (int ch = 0; ch < 2; ch++) {
-                recordHeads[ch].configure(sampleRate);
-                for (int head = 0; head < 4; head++) {
-                    playHeads[ch][head].configure(sampleRate);
-                    // Set different delay times for multi-head effect
-                    playHeads[ch][head].setDelayTime(100.0f + head * 50.0f); // 100ms, 150ms, 200ms, 250ms
-                }
+                tape[ch].configure(sampleRate);
             }
+            updateHeadTimes();
         }
     }
     
+    /**
+     * Build tape loops for a sample rate and free replaced ones
+     * 
+     * Background thread only; the audio thread threads the new tape at
+     * its next block.
+     */
+    void prepareTape(float forSampleRate) {
+        for (int ch = 0; ch < 2; ch++) {
+            tape[ch].prepare(forSampleRate);
+        }
+    }
+    
+    /**
+     * Free tape storage replaced on the audio thread (background thread only)
+     */
+    void collectBuffers() {
+        for (int ch = 0; ch < 2; ch++) {
+            tape[ch].buffer.collect();
+        }
+    }
+    
+    /**
+     * @return true if replaced tape is waiting for collectBuffers()
+     */
+    bool hasRetiredBuffers() const {
+        return tape[0].buffer.hasRetired() || tape[1].buffer.hasRetired();
+    }
+    
     /**
      * Reset all internal state
      */
@@ -164,16 +281,21 @@ public:
         for (int ch = 0; ch < 2; ch++) {
             agingLowpass[ch] = 0.0f;
             instabilityPhase[ch] = 0.0f;
+            singleHeadHighpass[ch] = 0.0f;
+            tripleHeadMidEQ[ch] = 0.0f;
+            quadHeadLowpass[ch] = 0.0f;
+            quadHeadMidboost[ch] = 0.0f;
         }
         
-        // Reset tape heads
+        // Reset tape loops; the engine restarts on the next enable
         for (int ch = 0; ch < 2; ch++) {
-            recordHeads[ch].configure(sampleRate);
-            for (int head = 0; head < 4; head++) {
-                playHeads[ch][head].configure(sampleRate);
-                playHeads[ch][head].setDelayTime(100.0f + head * 50.0f);
-            }
+            tape[ch].reset();
+            saturationOversampler[ch].reset();
+            limiterOversampler[ch].reset();
         }
+        tapeState = TAPE_OFF;
+        tapeMix.reset(0.0f);
+        updateHeadTimes();
         
         // Reset filters
         for (int i = 0; i < 2; i++) {
@@ -186,27 +308,63 @@ public:
     
     /**
      * Enable/disable tape mode
+     * 
+     * Safe to call every control period: only an off-to-on or on-to-off
+     * change does any work. Enabling a stopped engine starts it from
+     * clean filters and rewinds the tape without erasing it; the output
+     * then crossfades from the dry path to the tape path over
+     * TAPE_FADE_MS. Disabling fades back and stops the engine once the
+     * fade ends.
      */
     void setTapeMode(bool enabled) {
-        tapeModeEnabled = enabled;
-        
-        // CRITICAL FIX: When enabling tape mode, ensure heads are properly initialized
-        if (enabled) {
-            // Initialize tape heads with safe default delay times
-            for (int ch = 0; ch < 2; ch++) {
-                recordHeads[ch].configure(sampleRate);
-                for (int head = 0; head < 4; head++) {
-                    playHeads[ch][head].configure(sampleRate);
-                    // CRITICAL FIX: Set minimum delay time to prevent empty buffer reads
-                    float headDelayTime = std::max(50.0f + head * 50.0f, 10.0f); // Minimum 10ms delay
-                    playHeads[ch][head].setDelayTime(headDelayTime);
+        switch (tapeState) {
+            case TAPE_OFF:
+                if (enabled) {
+                    // CRITICAL FIX: When enabling tape mode, ensure the tape is properly initialized
+                    // (the tape loops themselves come from prepareTape() on the allocator thread,
+                    // and rewinding them does not touch the samples)
+                    initializeFilters();
+                    for (int ch = 0; ch < 2; ch++) {
+                        tape[ch].reset();
+                        saturationOversampler[ch].reset();
+                        limiterOversampler[ch].reset();
+                    }
+                    tapeState = TAPE_FADING_IN;
                 }
-            }
-            // Initialize filters to prevent startup clicks
-            initializeFilters();
+                break;
+            case TAPE_FADING_IN:
+            case TAPE_ON:
+                if (!enabled) {
+                    tapeState = TAPE_FADING_OUT;
+                }
+                break;
+            case TAPE_FADING_OUT:
+                // Still running, so just turn the fade around
+                if (enabled) {
+                    tapeState = TAPE_FADING_IN;
+                }
+                break;
         }
     }
     
+    /**
+     * Stop the engine at once, without a fade
+     * 
+     * For voice groups that are no longer processed, whose fades would
+     * otherwise never advance.
+     */
+    void stopTape() {
+        tapeState = TAPE_OFF;
+        tapeMix.reset(0.0f);
+    }
+    
+    /**
+     * @return true while the tape engine is running, including fades
+     */
+    bool isTapeActive() const {
+        return tapeState != TAPE_OFF;
+    }
+    
     /**
      * Configure wow and flutter parameters
      */
@@ -228,21 +386,25 @@ public:
     
     /**
      * Configure head bump EQ
+     * 
+     * @param rampSamples Samples to glide to new coefficients (0 = immediate)
      */
-    void setHeadBump(float frequency, float gain, float q) {
+    void setHeadBump(float frequency, float gain, float q, int rampSamples = 0) {
         bumpFrequency = frequency;
         bumpGain = gain;
         bumpQ = q;
-        updateBumpFilter();
+        updateBumpFilter(rampSamples);
     }
     
     /**
      * Configure high-frequency rolloff
+     * 
+     * @param rampSamples Samples to glide to new coefficients (0 = immediate)
      */
-    void setRolloff(float frequency, float resonance) {
+    void setRolloff(float frequency, float resonance, int rampSamples = 0) {
         rolloffFreq = frequency;
         rolloffResonance = resonance;
-        updateRolloffFilter();
+        updateRolloffFilter(rampSamples);
     }
     
     /**
@@ -290,6 +452,17 @@ public:
         instabilityAmount = amount;
     }
     
+    /**
+     * Override the play head delay times
+     * 
+     * Replaced again on the next head configuration change.
+     * 
+     * @param delayMs Delay of each head in ms (0 = head disabled)
+     */
+    void setHeadDelayTimes(float_4 delayMs) {
+        headDelayMs = simd::clamp(delayMs, 0.0f, 2000.0f);
+    }
+    
     /**
      * Set head configuration (0=single, 1=dual, 2=triple, 3=quad)
      */
@@ -298,37 +471,7 @@ public:
         
         // ===== CRITICAL FIX: Immediately update head delay times when configuration changes =====
         // This ensures users hear audible differences between head modes
-        for (int ch = 0; ch < 2; ch++) {
-            switch (headConfiguration) {
-                case 0: // Single head - 120ms delay
-                    playHeads[ch][0].setDelayTime(120.0f);
-                    playHeads[ch][1].setDelayTime(0.0f);   // Disable other heads
-                    playHeads[ch][2].setDelayTime(0.0f);
-                    playHeads[ch][3].setDelayTime(0.0f);
-                    break;
-                    
-                case 1: // Dual heads - 100ms and 170ms for stereo width
-                    playHeads[ch][0].setDelayTime(100.0f);
-                    playHeads[ch][1].setDelayTime(170.0f);
-                    playHeads[ch][2].setDelayTime(0.0f);   // Disable unused heads
-                    playHeads[ch][3].setDelayTime(0.0f);
-                    break;
-                    
-                case 2: // Triple heads - 80ms, 140ms, 200ms for rich complexity
-                    playHeads[ch][0].setDelayTime(80.0f);
-                    playHeads[ch][1].setDelayTime(140.0f);
-                    playHeads[ch][2].setDelayTime(200.0f);
-                    playHeads[ch][3].setDelayTime(0.0f);   // Disable unused head
-                    break;
-                    
-                case 3: // Quad heads - 70ms, 120ms, 180ms, 250ms for maximum complexity
-                    playHeads[ch][0].setDelayTime(70.0f);
-                    playHeads[ch][1].setDelayTime(120.0f);
-                    playHeads[ch][2].setDelayTime(180.0f);
-                    playHeads[ch][3].setDelayTime(250.0f);
-                    break;
-            }
-        }
+        updateHeadTimes();
     }
     
     /**
@@ -338,6 +481,21 @@ public:
         noiseAmount = amount;
     }
     
+    /**
+     * Oversample the saturation and the output limiter
+     * 
+     * The delay, EQ and noise stages stay at the host rate. Each of the two
+     * stages adds TOversampler::latencySamples(factor) of latency.
+     * 
+     * @param factor 1 (off), 2, 4 or 8
+     */
+    void setOversampling(int factor) {
+        for (int ch = 0; ch < 2; ch++) {
+            saturationOversampler[ch].setFactor(factor);
+            limiterOversampler[ch].setFactor(factor);
+        }
+    }
+    
     /**
      * Process a single audio sample through tape delay
      * 
@@ -345,8 +503,8 @@ public:
      * @param channel Channel index (0=left, 1=right)
      * @return Processed sample
      */
-    float process(float input, int channel) {
-        if (!tapeModeEnabled) {
+    T process(T input, int channel) {
+        if (tapeState == TAPE_OFF) {
             return input;
         }
         
@@ -356,38 +514,34 @@ public:
         }
         
         // CRITICAL FIX: Ensure input is not NaN or infinite
-        if (!std::isfinite(input)) {
-            return 0.0f;
-        }
+        input = replaceNonFinite(input, T(0.0f));
         
         // TAPE PROCESSING FLOW: Pre-EQ → Wow/Flutter → Saturation → Head Bump → Aging → Noise → Stereo Sum
         
         // STEP 1: Apply pre-emphasis EQ
-        float processed = preEmphasisFilter[channel].process(input);
+        T processed = preEmphasisFilter[channel].process(input);
         
         // CRITICAL FIX: Check for NaN after filtering
-        if (!std::isfinite(processed)) {
-            processed = input;
-        }
+        processed = replaceNonFinite(processed, input);
         
         // STEP 2: Apply wow and flutter modulation to delay time
         float modulationAmount = applyWowFlutter();
         
         // STEP 3: Apply tape saturation
-        processed = saturateSignal(processed);
+        processed = saturationOversampler[channel].process(processed, [this](T x) {
+            return saturateSignal(x);
+        });
         
         // CRITICAL FIX: Check for NaN after saturation
-        if (!std::isfinite(processed)) {
-            processed = input * 0.5f; // Fallback to attenuated dry signal
-        }
+        processed = replaceNonFinite(processed, input * 0.5f); // Fallback to attenuated dry signal
         
         // STEP 4: Multi-head delay processing
-        float delayedSignal = processMultiHeadDelay(processed, channel, modulationAmount);
+        T delayedSignal = processMultiHeadDelay(processed, channel, modulationAmount);
         
         // CRITICAL FIX: If delay processing fails, mix with dry signal
-        if (!std::isfinite(delayedSignal) || std::abs(delayedSignal) < 1e-10f) {
-            delayedSignal = processed * 0.8f; // Use processed dry signal as fallback
-        }
+        T fallback = processed * 0.8f; // Use processed dry signal as fallback
+        delayedSignal = simd::ifelse(simd::abs(delayedSignal) < 1e-10f, fallback, delayedSignal);
+        delayedSignal = replaceNonFinite(delayedSignal, fallback);
         
         processed = delayedSignal;
         
@@ -395,9 +549,7 @@ public:
         processed = applyHeadBumpEQ(processed, channel);
         
         // CRITICAL FIX: Check for NaN after EQ
-        if (!std::isfinite(processed)) {
-            processed = delayedSignal;
-        }
+        processed = replaceNonFinite(processed, delayedSignal);
         
         // STEP 6: Apply aging effects
         if (agingAmount > 0.001f) {
@@ -419,16 +571,70 @@ public:
         processed = applyStereoDecorelation(processed, channel);
         
         // CRITICAL FIX: Final safety clamp and NaN check
-        if (!std::isfinite(processed)) {
-            processed = input * 0.7f; // Ultimate fallback to dry signal
-        }
+        processed = replaceNonFinite(processed, input * 0.7f); // Ultimate fallback to dry signal
         
         // Soft limiting to prevent clipping
-        processed = std::tanh(processed * 0.8f) / 0.8f;
+        processed = limiterOversampler[channel].process(processed, [](T x) {
+            return fastTanh(x * 0.8f) / 0.8f;
+        });
         
         return processed;
     }
     
+    /**
+     * Process a stereo block of audio samples through tape delay
+     * 
+     * Left and right are processed per sample in the same order as two
+     * process() calls, so the shared wow/flutter LFOs advance identically.
+     * 
+     * @param inL Left input samples
+     * @param inR Right input samples
+     * @param outL Left output samples (may alias inL)
+     * @param outR Right output samples (may alias inR)
+     * @param n Number of samples in the block
+     */
+    void processBlock(const T* inL, const T* inR, T* outL, T* outR, int n) {
+        if (tapeState == TAPE_OFF) {
+            if (outL != inL) std::copy(inL, inL + n, outL);
+            if (outR != inR) std::copy(inR, inR + n, outR);
+            return;
+        }
+        
+        for (int ch = 0; ch < 2; ch++) {
+            tape[ch].update(n);
+        }
+        
+        // Move the dry/tape crossfade at most one fade length per TAPE_FADE_MS
+        float target = (tapeState == TAPE_FADING_OUT) ? 0.0f : 1.0f;
+        float maxStep = n / std::max(1.0f, TAPE_FADE_MS * 0.001f * sampleRate);
+        float next = tapeMix.value + std::max(-maxStep, std::min(target - tapeMix.value, maxStep));
+        tapeMix.setTarget(next, n);
+        
+        if (tapeState == TAPE_ON) {
+            for (int i = 0; i < n; i++) {
+                outL[i] = process(inL[i], 0);
+                outR[i] = process(inR[i], 1);
+            }
+        } else {
+            TLinearRamp<float> mix = tapeMix;
+            for (int i = 0; i < n; i++) {
+                float m = mix.next();
+                T dryL = inL[i];
+                T dryR = inR[i];
+                outL[i] = dryL + (process(dryL, 0) - dryL) * m;
+                outR[i] = dryR + (process(dryR, 1) - dryR) * m;
+            }
+        }
+        tapeMix.reset(next);
+        
+        // Fades end on a block boundary
+        if (tapeState == TAPE_FADING_IN && next >= 1.0f) {
+            tapeState = TAPE_ON;
+        } else if (tapeState == TAPE_FADING_OUT && next <= 0.0f) {
+            tapeState = TAPE_OFF;
+        }
+    }
+    
     /**
      * Process multi-head delay system
      * 
@@ -437,22 +643,26 @@ public:
      * @param modulation Wow/flutter modulation amount
      * @return Processed sample
      */
-    float processMultiHeadDelay(float input, int channel, float modulation) {
-        // Record head: Write to the tape buffer
-        recordHeads[channel].writeToTape(input);
+    T processMultiHeadDelay(T input, int channel, float modulation) {
+        // Record head: Write to the tape loop
+        tape[channel].writeToTape(input);
+        
+        // Play heads: every head reads the same loop in one pass, each at
+        // its own speed for progressive detune
+        T heads[TTapeLoop<T>::NUM_TAPS];
+        tape[channel].readTaps(headDelayMs, modulation * headSpeed, heads);
         
-        float output = 0.0f;
+        T output = 0.0f;
         
         // ===== CRITICAL FIX: Completely Rewritten Head Configuration System =====
         switch (headConfiguration) {
             case 0: // Single head - Clean, focused sound
                 {
                     // ===== CRITICAL FIX: Only read from active heads =====
-                    if (playHeads[channel][0].delayTime > 0.0f) {
-                        output = playHeads[channel][0].readFromTape(modulation);
+                    if (headDelayMs[0] > 0.0f) {
+                        output = heads[0];
                         
                         // Apply subtle EQ for single-head character (brighter)
-                        static std::array<float, 2> singleHeadHighpass = {0.0f, 0.0f};
                         float hpCoeff = 0.95f; // Light high-pass
                         singleHeadHighpass[channel] += (output - singleHeadHighpass[channel]) * hpCoeff;
                         output = output - singleHeadHighpass[channel] * 0.1f; // Slight high boost
@@ -463,14 +673,8 @@ public:
             case 1: // Dual heads - Stereo width and slight chorus
                 {
                     // ===== CRITICAL FIX: Check both heads are active and apply stereo routing =====
-                    float head1 = 0.0f, head2 = 0.0f;
-                    
-                    if (playHeads[channel][0].delayTime > 0.0f) {
-                        head1 = playHeads[channel][0].readFromTape(modulation);
-                    }
-                    if (playHeads[channel][1].delayTime > 0.0f) {
-                        head2 = playHeads[channel][1].readFromTape(modulation * 1.03f); // Slightly different rate
-                    }
+                    T head1 = heads[0];
+                    T head2 = heads[1]; // Slightly different rate
                     
                     // ===== CRITICAL FIX: Proper stereo panning for dual heads =====
                     if (channel == 0) {
@@ -490,27 +694,18 @@ public:
             case 2: // Triple heads - Rich harmonics and depth
                 {
                     // ===== CRITICAL FIX: Sum all active heads with progressive modulation =====
-                    float head1 = 0.0f, head2 = 0.0f, head3 = 0.0f;
-                    
-                    if (playHeads[channel][0].delayTime > 0.0f) {
-                        head1 = playHeads[channel][0].readFromTape(modulation);
-                    }
-                    if (playHeads[channel][1].delayTime > 0.0f) {
-                        head2 = playHeads[channel][1].readFromTape(modulation * 1.02f);
-                    }
-                    if (playHeads[channel][2].delayTime > 0.0f) {
-                        head3 = playHeads[channel][2].readFromTape(modulation * 1.05f);
-                    }
+                    T head1 = heads[0];
+                    T head2 = heads[1];
+                    T head3 = heads[2];
                     
                     // Mix with weighted blend for richness
                     output = head1 * 0.5f + head2 * 0.3f + head3 * 0.2f;
                     
                     // Add harmonic interaction between heads
-                    float harmonic = (head1 * head2 + head2 * head3) * 0.05f;
+                    T harmonic = (head1 * head2 + head2 * head3) * 0.05f;
                     output += harmonic;
                     
                     // Apply mid-frequency emphasis for warmth
-                    static std::array<float, 2> tripleHeadMidEQ = {0.0f, 0.0f};
                     float midCoeff = 0.85f;
                     tripleHeadMidEQ[channel] += (output - tripleHeadMidEQ[channel]) * midCoeff;
                     output = output + tripleHeadMidEQ[channel] * 0.1f; // Mid boost
@@ -520,32 +715,19 @@ public:
             case 3: // Quad heads - Maximum complexity and vintage character
                 {
                     // ===== CRITICAL FIX: Read from all active heads with distinct characteristics =====
-                    float head1 = 0.0f, head2 = 0.0f, head3 = 0.0f, head4 = 0.0f;
-                    
-                    if (playHeads[channel][0].delayTime > 0.0f) {
-                        head1 = playHeads[channel][0].readFromTape(modulation);           // Main head
-                    }
-                    if (playHeads[channel][1].delayTime > 0.0f) {
-                        head2 = playHeads[channel][1].readFromTape(modulation * 1.015f);  // Slight detune
-                    }
-                    if (playHeads[channel][2].delayTime > 0.0f) {
-                        head3 = playHeads[channel][2].readFromTape(modulation * 1.03f);   // More detune
-                    }
-                    if (playHeads[channel][3].delayTime > 0.0f) {
-                        head4 = playHeads[channel][3].readFromTape(modulation * 1.045f);  // Maximum detune
-                    }
+                    T head1 = heads[0]; // Main head
+                    T head2 = heads[1]; // Slight detune
+                    T head3 = heads[2]; // More detune
+                    T head4 = heads[3]; // Maximum detune
                     
                     // Progressive mixing for complex texture
                     output = head1 * 0.4f + head2 * 0.25f + head3 * 0.2f + head4 * 0.15f;
                     
                     // Add inter-head modulation for vintage tape character
-                    float intermod = (head1 * head3 - head2 * head4) * 0.03f;
+                    T intermod = (head1 * head3 - head2 * head4) * 0.03f;
                     output += intermod;
                     
                     // Apply complex EQ curve for vintage warmth
-                    static std::array<float, 2> quadHeadLowpass = {0.0f, 0.0f};
-                    static std::array<float, 2> quadHeadMidboost = {0.0f, 0.0f};
-                    
                     // Low-pass for warmth
                     float lpCoeff = 0.75f;
                     quadHeadLowpass[channel] += (output - quadHeadLowpass[channel]) * lpCoeff;
@@ -558,23 +740,11 @@ public:
                     output = quadHeadLowpass[channel] * 0.7f + (output + quadHeadMidboost[channel] * 0.08f) * 0.3f;
                     
                     // Add subtle saturation for tape character
-                    output = std::tanh(output * 1.1f) / 1.1f;
+                    output = fastTanh(output * 1.1f) / 1.1f;
                 }
                 break;
         }
         
-        // ===== CRITICAL FIX: Ensure proper head spacing and timing =====
-        // Set different delay times based on head configuration for clear sonic differences
-        if (headConfiguration >= 0 && headConfiguration <= 3) {
-            // Update head delay times to create distinct sonic characteristics
-            float baseDelay = 80.0f; // Base delay time in ms
-            
-            for (int head = 0; head < 4; head++) {
-                float headDelayTime = baseDelay + head * (30.0f + headConfiguration * 10.0f);
-                playHeads[channel][head].setDelayTime(headDelayTime);
-            }
-        }
-        
         return output;
     }
     
@@ -585,7 +755,7 @@ public:
      * @param channel Channel index
      * @return Processed sample
      */
-    float applyAgingEffects(float input, int channel) {
+    T applyAgingEffects(T input, int channel) {
         // ===== CRITICAL FIX: Much more responsive aging effect =====
         
         // High frequency loss due to tape aging - exponential curve for better control
@@ -597,7 +767,7 @@ public:
         
         // ===== CRITICAL FIX: Add tape degradation artifacts =====
         // Slight modulation and warping becomes more noticeable
-        float agingMod = 1.0f + std::sin(wowPhase * 13.7f) * agingAmount * 0.1f; // Increased from 0.02f
+        float agingMod = 1.0f + fastSin(wowPhase * 13.7f) * agingAmount * 0.1f; // Increased from 0.02f
         
         // Add some random dropouts for aged tape - more frequent at higher aging
         if (agingAmount > 0.3f && randomUniform(0.0f, 1.0f) < agingAmount * 0.0005f) { // Increased dropout frequency
@@ -605,7 +775,7 @@ public:
         }
         
         // ===== CRITICAL FIX: Add tape compression/limiting simulation =====
-        float compressed = std::tanh(agingLowpass[channel] * agingMod * (1.0f + agingAmount * 0.5f));
+        T compressed = fastTanh(agingLowpass[channel] * agingMod * (1.0f + agingAmount * 0.5f));
         
         // ===== CRITICAL FIX: More aggressive blending for audible effect =====
         float wetAmount = agingAmount * 0.8f; // Increased from 0.4f
@@ -619,7 +789,7 @@ public:
      * @param channel Channel index
      * @return Processed sample
      */
-    float applyInstabilityEffects(float input, int channel) {
+    T applyInstabilityEffects(T input, int channel) {
         // ===== CRITICAL FIX: Exponential scaling for instability =====
         // Apply square curve to make low levels more subtle
         float scaledInstability = instabilityAmount * instabilityAmount;
@@ -629,7 +799,7 @@ public:
         if (instabilityPhase[channel] >= 1.0f) instabilityPhase[channel] -= 1.0f;
         
         // ===== CRITICAL FIX: Much more subtle level variations =====
-        float levelMod = 1.0f + std::sin(instabilityPhase[channel] * 2.0f * M_PI) * scaledInstability * 0.05f; // Reduced from 0.15f
+        float levelMod = 1.0f + fastSin(instabilityPhase[channel] * 2.0f * float(M_PI)) * scaledInstability * 0.05f; // Reduced from 0.15f
         
         // ===== CRITICAL FIX: Reduce random dropout frequency significantly =====
         if (randomUniform(0.0f, 1.0f) < scaledInstability * 0.0002f) { // Reduced from 0.002f
@@ -637,7 +807,7 @@ public:
         }
         
         // ===== CRITICAL FIX: Much more subtle speed variations =====
-        float speedVar = 1.0f + std::sin(instabilityPhase[channel] * 7.3f * M_PI) * scaledInstability * 0.01f; // Reduced from 0.05f
+        float speedVar = 1.0f + fastSin(instabilityPhase[channel] * 7.3f * float(M_PI)) * scaledInstability * 0.01f; // Reduced from 0.05f
         
         return input * levelMod * speedVar;
     }
@@ -649,13 +819,13 @@ public:
      * @param channel Channel index
      * @return Decorrelated sample
      */
-    float applyStereoDecorelation(float input, int channel) {
+    T applyStereoDecorelation(T input, int channel) {
         // Apply different modulation per channel for stereo width
         float channelOffset = (channel == 0) ? 0.0f : 0.25f; // 90-degree phase offset for right channel
         float decorrelationPhase = wowPhase + flutterPhase * 0.7f + channelOffset;
         
         // Subtle decorrelation modulation
-        float decorrelation = 1.0f + std::sin(decorrelationPhase * 2.0f * M_PI * 3.17f) * 0.02f;
+        float decorrelation = 1.0f + fastSin(decorrelationPhase * 2.0f * float(M_PI) * 3.17f) * 0.02f;
         
         return input * decorrelation;
     }
@@ -666,7 +836,7 @@ public:
      * @return Modulation value to apply to delay time (1.0 = no modulation)
      */
     float applyWowFlutter() {
-        if (!tapeModeEnabled || (wowDepth < 0.001f && flutterDepth < 0.001f)) {
+        if (tapeState == TAPE_OFF || (wowDepth < 0.001f && flutterDepth < 0.001f)) {
             return 1.0f;
         }
         
@@ -686,7 +856,7 @@ public:
         float wowMod = 0.0f;
         switch (wowWaveform) {
             case SINE:
-                wowMod = std::sin(2.0f * M_PI * wowPhase);
+                wowMod = fastSin(2.0f * float(M_PI) * wowPhase);
                 break;
             case TRIANGLE:
                 // Triangle wave
@@ -705,7 +875,7 @@ public:
         float flutterMod = 0.0f;
         switch (flutterWaveform) {
             case SINE:
-                flutterMod = std::sin(2.0f * M_PI * flutterPhase);
+                flutterMod = fastSin(2.0f * float(M_PI) * flutterPhase);
                 break;
             case TRIANGLE:
                 // Triangle wave
@@ -736,18 +906,18 @@ public:
      * @param input Input sample
      * @return Saturated sample
      */
-    float saturateSignal(float input) {
-        if (!tapeModeEnabled || saturationAmount < 0.001f) {
+    T saturateSignal(T input) {
+        if (tapeState == TAPE_OFF || saturationAmount < 0.001f) {
             return input;
         }
         
         // Drive amount (increases with saturation)
         float drive = 1.0f + saturationAmount * 5.0f;
-        float wetSignal = input * drive;
+        T wetSignal = input * drive;
         
         // Soft clipping using tanh (hyperbolic tangent)
         // More extreme at higher saturation values
-        wetSignal = std::tanh(wetSignal);
+        wetSignal = fastTanh(wetSignal);
         
         // Blend between dry and saturated signal based on saturation amount
         return input * (1.0f - saturationAmount) + wetSignal * saturationAmount;
@@ -760,22 +930,19 @@ public:
      * @param channel Channel index (0=left, 1=right)
      * @return Processed sample
      */
-    float applyHeadBumpEQ(float input, int channel) {
-        if (!tapeModeEnabled) {
+    T applyHeadBumpEQ(T input, int channel) {
+        if (tapeState == TAPE_OFF) {
             return input;
         }
         
-        // Apply pre-emphasis (boosts highs before processing)
-        float preEmph = preEmphasisFilter[channel].process(input);
+        // Pre/de-emphasis are applied around the tape in process(); running the
+        // same filter instances here would leak the tape output into the record path
         
         // Apply bass bump (centered around delay resonance frequency)
-        float bumped = bumpFilter[channel].process(preEmph);
+        T bumped = bumpFilter[channel].process(input);
         
         // Apply high-frequency rolloff
-        float rolled = rolloffFilter[channel].process(bumped);
-        
-        // Apply de-emphasis (cuts highs after processing)
-        return deEmphasisFilter[channel].process(rolled);
+        return rolloffFilter[channel].process(bumped);
     }
     
     /**
@@ -808,10 +975,9 @@ public:
         // 2. 60Hz hum (very subtle)
         humPhase += humFrequency / sampleRate;
         if (humPhase >= 1.0f) humPhase -= 1.0f;
-        float hum = std::sin(2.0f * M_PI * humPhase) * scaledNoise * 0.1f; // 10% of main noise
+        float hum = fastSin(2.0f * float(M_PI) * humPhase) * scaledNoise * 0.1f; // 10% of main noise
         
         // 3. High-frequency tape artifacts (very rare)
-        static int artifactCounter = 0;
         float artifacts = 0.0f;
         artifactCounter++;
         if (artifactCounter > 44100 && randomUniform(0.0f, 1.0f) < scaledNoise * 0.1f) {
@@ -820,10 +986,9 @@ public:
         }
         
         // 4. Low-frequency rumble (DC offset simulation)
-        static float rumblePhase = 0.0f;
         rumblePhase += 1.7f / sampleRate; // Very low frequency
         if (rumblePhase >= 1.0f) rumblePhase -= 1.0f;
-        float rumble = std::sin(2.0f * M_PI * rumblePhase) * scaledNoise * 0.05f;
+        float rumble = fastSin(2.0f * float(M_PI) * rumblePhase) * scaledNoise * 0.05f;
         
         // ===== CRITICAL FIX: Combine all noise components additively =====
         float totalNoise = tapeHiss + hum + artifacts + rumble;
@@ -835,12 +1000,15 @@ public:
     }
 
     // Multi-head delay system (public for external access)
-    std::array<TapeHead, 2> recordHeads;           // Record heads for L/R channels
-    std::array<std::array<TapeHead, 4>, 2> playHeads; // Up to 4 playback heads per channel
+    std::array<TTapeLoop<T>, 2> tape;  // One tape loop per channel, shared by all heads
 
 private:
     float sampleRate;
-    std::atomic<bool> tapeModeEnabled;
+    
+    // Engine state and dry/tape crossfade (audio thread)
+    static constexpr float TAPE_FADE_MS = 5.0f;
+    TapeState tapeState;
+    TLinearRamp<float> tapeMix;
     
     // Wow & Flutter
     float wowRate;
@@ -857,32 +1025,47 @@ private:
     // Tape Saturation
     float saturationAmount;
     
+    // Nonlinear stages run through these at the selected oversampling factor
+    std::array<TOversampler<T>, 2> saturationOversampler;
+    std::array<TOversampler<T>, 2> limiterOversampler;
+    
     // Head Bump EQ
     float bumpFrequency;
     float bumpGain;
     float bumpQ;
     float rolloffFreq;
     float rolloffResonance;
-    std::array<rack::dsp::BiquadFilter, 2> bumpFilter;
-    std::array<rack::dsp::BiquadFilter, 2> rolloffFilter;
-    std::array<rack::dsp::BiquadFilter, 2> preEmphasisFilter;
-    std::array<rack::dsp::BiquadFilter, 2> deEmphasisFilter;
+    // Coefficients are cached and only redesigned when their inputs change
+    std::array<TCachedBiquad<T>, 2> bumpFilter;
+    std::array<TCachedBiquad<T>, 2> rolloffFilter;
+    std::array<TCachedBiquad<T>, 2> preEmphasisFilter;
+    std::array<TCachedBiquad<T>, 2> deEmphasisFilter;
     
     // Tape Noise
     bool noiseEnabled;
     float noiseAmount;
     float humFrequency;
     float humPhase;
+    float rumblePhase = 0.0f;
+    int artifactCounter = 0;
     
     // Tape aging and instability
     float agingAmount = 0.0f;
     float instabilityAmount = 0.0f;
     int headConfiguration = 0;
+    float_4 headDelayMs = 0.0f;   // Per play head, 0 = unused
+    float_4 headSpeed = 1.0f;     // Per play head delay time scale
     
     // Aging and instability state
-    std::array<float, 2> agingLowpass = {0.0f, 0.0f};
+    std::array<T, 2> agingLowpass = {};
     std::array<float, 2> instabilityPhase = {0.0f, 0.0f};
     
+    // Per-channel head EQ state for the multi-head configurations
+    std::array<T, 2> singleHeadHighpass = {};
+    std::array<T, 2> tripleHeadMidEQ = {};
+    std::array<T, 2> quadHeadLowpass = {};
+    std::array<T, 2> quadHeadMidboost = {};
+    
     // Pink noise filter
     struct PinkNoiseFilter {
         float b0, b1, b2, b3, b4, b5, b6;
@@ -912,6 +1095,29 @@ private:
         return min + dist(rng) * (max - min);
     }
     
+    /**
+     * Set play head delay times and speeds for the head configuration
+     */
+    void updateHeadTimes() {
+        // ===== CRITICAL FIX: Ensure proper head spacing and timing =====
+        // Set different delay times based on head configuration for clear sonic differences
+        float baseDelay = 80.0f; // Base delay time in ms
+        float spacing = 30.0f + headConfiguration * 10.0f;
+        int activeHeads = headConfiguration + 1;
+        for (int head = 0; head < TTapeLoop<T>::NUM_TAPS; head++) {
+            // Unused heads are disabled so they are never read
+            headDelayMs[head] = (head < activeHeads) ? baseDelay + head * spacing : 0.0f;
+        }
+        
+        // Progressively faster heads detune against each other
+        switch (headConfiguration) {
+            case 0: headSpeed = float_4(1.0f, 1.0f, 1.0f, 1.0f); break;
+            case 1: headSpeed = float_4(1.0f, 1.03f, 1.0f, 1.0f); break;
+            case 2: headSpeed = float_4(1.0f, 1.02f, 1.05f, 1.0f); break;
+            case 3: headSpeed = float_4(1.0f, 1.015f, 1.03f, 1.045f); break;
+        }
+    }
+    
     /**
      * Initialize all filters
      */
@@ -924,13 +1130,13 @@ private:
         
         // Initialize pre-emphasis filter (boost highs before processing)
         for (int i = 0; i < 2; i++) {
-            preEmphasisFilter[i].setParameters(rack::dsp::BiquadFilter::HIGHSHELF, 2000.0f / sampleRate, 0.7f, 2.0f);
+            preEmphasisFilter[i].setParameters(rack::dsp::BiquadFilter::HIGHSHELF, 2000.0f, 0.7f, 2.0f, sampleRate);
             preEmphasisFilter[i].reset();
         }
         
         // Initialize de-emphasis filter (cut highs after processing)
         for (int i = 0; i < 2; i++) {
-            deEmphasisFilter[i].setParameters(rack::dsp::BiquadFilter::HIGHSHELF, 2000.0f / sampleRate, 0.7f, 0.5f);
+            deEmphasisFilter[i].setParameters(rack::dsp::BiquadFilter::HIGHSHELF, 2000.0f, 0.7f, 0.5f, sampleRate);
             deEmphasisFilter[i].reset();
         }
     }
@@ -938,20 +1144,22 @@ private:
     /**
      * Update the head bump filter parameters
      */
-    void updateBumpFilter() {
+    void updateBumpFilter(int rampSamples = 0) {
         for (int i = 0; i < 2; i++) {
-            bumpFilter[i].setParameters(rack::dsp::BiquadFilter::PEAK, bumpFrequency / sampleRate, bumpQ, bumpGain);
+            bumpFilter[i].setParameters(rack::dsp::BiquadFilter::PEAK, bumpFrequency, bumpQ, bumpGain, sampleRate, rampSamples);
         }
     }
     
     /**
      * Update the high-frequency rolloff filter parameters
      */
-    void updateRolloffFilter() {
+    void updateRolloffFilter(int rampSamples = 0) {
         for (int i = 0; i < 2; i++) {
-            rolloffFilter[i].setParameters(rack::dsp::BiquadFilter::LOWPASS, rolloffFreq / sampleRate, rolloffResonance, 1.0f);
+            rolloffFilter[i].setParameters(rack::dsp::BiquadFilter::LOWPASS, rolloffFreq, rolloffResonance, 1.0f, sampleRate, rampSamples);
         }
     }
 };
 
+typedef TTapeDelayProcessor<> TapeDelayProcessor;
+
 } // namespace CurveAndDrag
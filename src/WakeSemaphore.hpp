@@ -0,0 +1,81 @@
+#pragma once
+
+#ifdef _WIN32
+    #ifndef NOMINMAX
+        #define NOMINMAX
+    #endif
+    #include <windows.h>
+    #include <climits>
+#elif defined(__APPLE__)
+    #include <dispatch/dispatch.h>
+#else
+    #include <semaphore.h>
+#endif
+
+namespace CurveAndDrag {
+
+/**
+ * WakeSemaphore - Counting semaphore for waking a sleeping thread
+ *
+ * post() never blocks and takes no lock, so the audio thread can wake a
+ * worker with it; notifying a condition variable needs the waiter's mutex
+ * to avoid lost wake-ups.
+ */
+class WakeSemaphore {
+public:
+    WakeSemaphore() {
+#ifdef _WIN32
+        handle = CreateSemaphore(nullptr, 0, LONG_MAX, nullptr);
+#elif defined(__APPLE__)
+        handle = dispatch_semaphore_create(0);
+#else
+        sem_init(&handle, 0, 0);
+#endif
+    }
+
+    ~WakeSemaphore() {
+#ifdef _WIN32
+        CloseHandle(handle);
+#elif defined(__APPLE__)
+        dispatch_release(handle);
+#else
+        sem_destroy(&handle);
+#endif
+    }
+
+    WakeSemaphore(const WakeSemaphore&) = delete;
+    WakeSemaphore& operator=(const WakeSemaphore&) = delete;
+
+    void post() {
+#ifdef _WIN32
+        ReleaseSemaphore(handle, 1, nullptr);
+#elif defined(__APPLE__)
+        dispatch_semaphore_signal(handle);
+#else
+        sem_post(&handle);
+#endif
+    }
+
+    void wait() {
+#ifdef _WIN32
+        WaitForSingleObject(handle, INFINITE);
+#elif defined(__APPLE__)
+        dispatch_semaphore_wait(handle, DISPATCH_TIME_FOREVER);
+#else
+        while (sem_wait(&handle) != 0) {
+            // Interrupted by a signal; wait again
+        }
+#endif
+    }
+
+private:
+#ifdef _WIN32
+    HANDLE handle;
+#elif defined(__APPLE__)
+    dispatch_semaphore_t handle;
+#else
+    sem_t handle;
+#endif
+};
+
+} // namespace CurveAndDrag